@@ -0,0 +1,652 @@
+/**
+ * Compile-time benchmark runner (POSIX).
+ * Generates one translation unit per (case, size), compiles each separately
+ * and appends wall time, peak compiler RSS and instantiation statistics to CSV:
+ *      case,size,compiler,status,wall_s,peak_rss_kb,inst_count,inst_time_s
+ *
+ * status      - ok | error | timeout | skipped (after timeout on smaller input) | exec_failed
+ * inst_count  - number of InstantiateClass/InstantiateFunction events (clang, -ftime-trace)
+ * inst_time_s - "template instantiation" phase wall time (gcc, -ftime-report)
+ *
+ * Usage:
+ *      compile_bench --cxx <compiler> --include <dir> [--out <dir>]
+ *                    [--compiler-id GNU|Clang] [--csv <file>] [--filter <substr>]
+ *                    [--max-size <n>] [--timeout <cpu seconds>] [--memory-limit <MB>]
+ *                    [--flags "<extra compiler flags>"]
+ *
+ * Sources, objects, logs and results.csv go to --out, by default compile_bench/
+ * in the directory of the runner executable (the build tree).
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace {
+
+using std::size_t;
+
+/// --- Inputs generation --- ///
+
+/// Deterministic shuffle (LCG driven), same inputs on every run
+std::vector<size_t> keys(size_t n, bool shuffled) {
+    std::vector<size_t> result(n);
+    for(size_t i = 0; i < n; ++i)
+        result[i] = i;
+
+    unsigned long long seed = 0x2545F4914F6CDD1DULL;
+    for(size_t i = n; shuffled && i > 1; --i) {
+        seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+        std::swap(result[i - 1], result[(seed >> 33) % i]);
+    }
+    return result;
+}
+
+/// Midpoint-first order of [from, to): inserting it yields perfect tree for to - from == 2^k - 1
+void balanced_order(size_t from, size_t to, std::vector<size_t>& out) {
+    if(from == to)
+        return;
+    out.push_back(from + (to - from)/2);
+    balanced_order(from, from + (to - from)/2, out);
+    balanced_order(from + (to - from)/2 + 1, to, out);
+}
+
+/// std::tuple<math::num_t<k0>, ..., math::num_t<kN-1>>
+std::string num_list(std::vector<size_t> const& ks) {
+    std::ostringstream out;
+    out << "std::tuple<";
+    auto n = ks.size();
+    for(size_t i = 0; i < n; ++i)
+        out << (i ? "," : "") << "math::num_t<" << ks[i] << ">";
+    out << ">";
+    return out.str();
+}
+
+std::string num_list(size_t n, bool shuffled = false) {
+    return num_list(keys(n, shuffled)); }
+
+/// Comma-separated numbers 0..N-1
+std::string num_values(size_t n) {
+    std::ostringstream out;
+    for(size_t i = 0; i < n; ++i)
+        out << (i ? "," : "") << i;
+    return out.str();
+}
+
+/// Quoted literal of N characters over small alphabet (many partial matches)
+std::string literal(size_t n) {
+    std::string result = "\"";
+    auto ks = keys(n, true);
+    for(size_t i = 0; i < n; ++i)
+        result += "abc"[ks[i] % 3];
+    return result + "\"";
+}
+
+std::string to_s(size_t n) { return std::to_string(n); }
+
+/// Sizes: [from, to] with doubling step
+std::vector<size_t> doubling(size_t from, size_t to) {
+    std::vector<size_t> result;
+    for(size_t n = from; n <= to; n *= 2)
+        result.push_back(n);
+    return result;
+}
+
+
+/// --- Cases --- ///
+
+struct bench_case {
+    std::string name;
+    std::vector<size_t> sizes;
+    std::string (*body)(size_t n);      // namespace-scope code, must instantiate facility
+};
+
+std::string tuple_input(size_t n) {
+    return "using input = " + num_list(n) + ";\n"; }
+
+std::string string_input(size_t n) {
+    return
+        "DEFINE_LITERAL(lit_a, " + literal(n) + ");\n"
+        "DEFINE_LITERAL(lit_b, " + literal(n) + ");\n"
+        "using str_a = ctstr::string<lit_a>;\n"
+        "using str_b = ctstr::string<lit_b>;\n";
+}
+
+/// tree_t is built as builder + "input, num_comp>" (plain, AVL or bulk construction)
+std::string tree_input(std::vector<size_t> const& ks, std::string const& builder = "tree::insert_tuple_t<tree::NIL, ") {
+    return
+        "struct num_comp : tree::eq_traits<math::num_less> {};\n"
+        "using input = " + num_list(ks) + ";\n"
+        "using tree_t = " + builder + "input, num_comp>;\n";
+}
+
+std::string tree_input(size_t n, bool shuffled = true, std::string const& builder = "tree::insert_tuple_t<tree::NIL, ") {
+    return tree_input(keys(n, shuffled), builder); }
+
+/// tree_t over keys [0, n) and other_t over [n/2, n/2 + n), both balanced
+std::string set_input(size_t n) {
+    std::vector<size_t> ks(n);
+    for(size_t i = 0; i < n; ++i)
+        ks[i] = n/2 + i;
+    return tree_input(n, false, "tree::build_balanced_t<") +
+        "using other_t = tree::build_balanced_t<" + num_list(ks) + ", num_comp>;\n";
+}
+
+/// map_t of shuffled keys k => num_t<2k>, built from entries tuple
+std::string map_input(size_t n) {
+    std::ostringstream out;
+    out << "using entries = std::tuple<";
+    auto ks = keys(n, true);
+    for(size_t i = 0; i < n; ++i)
+        out << (i ? "," : "") << "tree::entry<math::num_t<" << ks[i] << ">, math::num_t<" << 2*ks[i] << ">>";
+    out << ">;\n";
+    return
+        "struct num_comp : tree::eq_traits<math::num_less> {};\n"
+        "using input = " + num_list(n) + ";\n" + out.str() +
+        "using map_t = tree::build_map_t<entries, num_comp>;\n";
+}
+
+/// N distinct literals key_<i> "k<i>" and key_set = head + "string<key_0>, ...>"
+std::string key_set_input(size_t n, std::string const& head) {
+    std::ostringstream out;
+    for(size_t i = 0; i < n; ++i)
+        out << "DEFINE_LITERAL(key_" << i << ", \"k" << i << "\");\n";
+    out << "using key_set = " << head;
+    for(size_t i = 0; i < n; ++i)
+        out << (i ? "," : "") << "ctstr::string<key_" << i << ">";
+    out << ">;\n";
+    return out.str();
+}
+
+std::vector<bench_case> const& cases() {
+    auto const tuples  = doubling(64, 8192);
+    auto const strings = doubling(16, 16384);
+    auto const trees   = doubling(16, 4096);
+    auto const primes  = std::vector<size_t>{
+        101, 1009, 10007, 100003, 1000003, 10000019, 100000007, 1000000007};
+
+    static std::vector<bench_case> const list = {
+        /// ct
+        {"input_tuple", tuples, [](size_t n) {
+            return tuple_input(n) +
+            "static_assert(std::tuple_size<input>::value == " + to_s(n) + ", \"\");\n"; }},
+        {"make_index_sequence", tuples, [](size_t n) {
+            return "static_assert(make_index_sequence_t<" + to_s(n) + ">::size == " + to_s(n) + ", \"\");\n"; }},
+        {"tuple_concat", tuples, [](size_t n) {
+            return tuple_input(n) +
+            "static_assert(std::tuple_size<tuple_concat_t<input,input>>::value == " + to_s(2*n) + ", \"\");\n"; }},
+        {"tuple_concat_many", tuples, [](size_t n) {
+            std::string lists;
+            for(size_t i = 0; i < n; ++i)
+                lists += std::string(i ? "," : "") + "std::tuple<math::num_t<" + to_s(i) + ">>";
+            return tuple_input(n) +
+            "static_assert(std::is_same<tuple_concat_t<" + lists + ">, input>::value, \"\");\n"; }},
+        {"tuple_push", tuples, [](size_t n) {
+            return tuple_input(n) +
+            "static_assert(std::tuple_size<tuple_push_t<input,void>>::value == " + to_s(n + 1) + ", \"\");\n"; }},
+        {"tuple_at", tuples, [](size_t n) {
+            return tuple_input(n) +
+            "static_assert(tuple_at_t<input," + to_s(n - 1) + ">::value == " + to_s(n - 1) + ", \"\");\n"; }},
+        {"tuple_drop", tuples, [](size_t n) {
+            return tuple_input(n) +
+            "static_assert(std::tuple_size<tuple_drop_t<input," + to_s(n/2) + ">>::value == " + to_s(n - n/2) + ", \"\");\n"; }},
+        {"tuple_take", tuples, [](size_t n) {
+            return tuple_input(n) +
+            "static_assert(std::tuple_size<tuple_take_t<input," + to_s(n/2) + ">>::value == " + to_s(n/2) + ", \"\");\n"; }},
+        {"tuple_transform", tuples, [](size_t n) {
+            return tuple_input(n) +
+            "using result = tuple_transform_t<input," + to_s(n/4) + "," + to_s(n/4 + n/2) + ",std::add_pointer>;\n"
+            "static_assert(std::tuple_size<result>::value == " + to_s(n/2) + ", \"\");\n"; }},
+        {"tuple_transform_linear", tuples, [](size_t n) {
+            return tuple_input(n) +
+            "using result = tuple_transform_linear<input," + to_s(n/4) + "," + to_s(n/4 + n/2) + ",std::add_pointer>::type;\n"
+            "static_assert(std::tuple_size<result>::value == " + to_s(n/2) + ", \"\");\n"; }},
+        {"tuple_reduce", tuples, [](size_t n) {
+            return tuple_input(n) +
+            "template <typename U, typename V> struct sum { using type = math::num_t<U::value + V::value>; };\n"
+            "static_assert(tuple_reduce_t<input, sum, math::num_t<0>>::value == " + to_s(n*(n - 1)/2) + ", \"\");\n"; }},
+        {"tuple_reduce_tree", tuples, [](size_t n) {
+            return tuple_input(n) +
+            "template <typename U, typename V> struct sum { using type = math::num_t<U::value + V::value>; };\n"
+            "static_assert(tuple_reduce_tree_t<input, sum>::value == " + to_s(n*(n - 1)/2) + ", \"\");\n"; }},
+
+        /// ct::math, containers
+        {"math_tuple_to_array", tuples, [](size_t n) {
+            return tuple_input(n) +
+            "static_assert(math::tuple_to_array_t<input>::values[" + to_s(n - 1) + "] == " + to_s(n - 1) + ", \"\");\n"; }},
+        {"math_array_to_tuple", tuples, [](size_t n) {
+            return
+            "struct holder { static constexpr const size_t values[] = {" + num_values(n) + "}; };\n"
+            "constexpr const size_t holder::values[];\n"
+            "static_assert(std::tuple_size<math::array_to_tuple_t<holder>>::value == " + to_s(n) + ", \"\");\n"; }},
+
+        /// ct::ctstr
+        {"ctstr_strlen", strings, [](size_t n) {
+            return "static_assert(ctstr::strlen(" + literal(n) + ") == " + to_s(n) + ", \"\");\n"; }},
+        {"ctstr_find_substr", strings, [](size_t n) {
+            auto lit = literal(n);
+            auto needle = "\"" + lit.substr(lit.size() - 1 - (n < 8 ? n : 8));
+            return "static_assert(ctstr::find_substr(" + lit + ", " + needle + ") != ctstr::npos, \"\");\n"; }},
+        {"ctstr_count_substr", strings, [](size_t n) {
+            return "static_assert(ctstr::count_substr(" + literal(n) + ", \"ab\") < " + to_s(n) + ", \"\");\n"; }},
+        {"ctstr_find_all", strings, [](size_t n) {
+            return string_input(n) +
+            "DEFINE_LITERAL(needle, \"ab\");\n"
+            "static_assert(ctstr::find_all<str_a, needle>::size == ctstr::count_substr(str_a::str(), \"ab\"), \"\");\n"; }},
+        {"ctstr_searcher", strings, [](size_t n) { // filter positions and unrolled verification
+            return string_input(n) +
+            "static_assert(ctstr::searcher<str_a>::second < " + to_s(n) + ", \"\");\n"
+            "bool (*verify)(char const*) = &ctstr::searcher<str_a>::verify;\n"; }},
+        {"ctstr_perfect_hash", trees, [](size_t n) { // table construction and compile-time lookup
+            return key_set_input(n, "ctstr::perfect_hash<") +
+            "static_assert(key_set::lookup(\"k" + to_s(n/2) + "\") == " + to_s(n/2) + ", \"\");\n"; }},
+        {"ctstr_string_hash", strings, [](size_t n) { // FNV-1a, XXH64 and CRC-32C of one string
+            return string_input(n) +
+            "static_assert(ctstr::hash_of<ctstr::fnv1a, str_a>::value != ctstr::hash_of<ctstr::xxhash64, str_a>::value, \"\");\n"
+            "static_assert(ctstr::hash_of<ctstr::crc32c, str_a>::value != 0, \"\");\n"; }},
+        {"ctstr_string_switch", trees, [](size_t n) { // case hashes and collision check
+            return key_set_input(n, "ctstr::string_switch<ctstr::xxhash64,") +
+            "static_assert(key_set::label<ctstr::string<key_" + to_s(n/2) + ">>() != 0, \"\");\n"; }},
+        {"ctstr_aho_corasick", trees, [](size_t n) { // trie, failure links and transition table
+            return key_set_input(n, "std::tuple<") +
+            "static_assert(ctstr::aho_corasick<key_set>::states > " + to_s(n) + ", \"\");\n"; }},
+        {"ctstr_string_at", strings, [](size_t n) {
+            return string_input(n) +
+            "static_assert(str_a::at(" + to_s(n - 1) + ") != '\\0', \"\");\n"; }},
+        {"ctstr_substr", strings, [](size_t n) {
+            return string_input(n) +
+            "static_assert(str_a::substr_t<" + to_s(n/4) + "," + to_s(n/4 + n/2) + ">::length == " + to_s(n/2) + ", \"\");\n"; }},
+        {"ctstr_concat", strings, [](size_t n) {
+            return string_input(n) +
+            "static_assert(ctstr::concat_t<str_a,str_b>::length == " + to_s(2*n) + ", \"\");\n"; }},
+        {"ctstr_eq", strings, [](size_t n) {
+            return string_input(n) +
+            "static_assert(ctstr::eq<str_a,str_b>::value, \"\");\n"; }},
+        {"ctstr_compare", strings, [](size_t n) {
+            return string_input(n) +
+            "static_assert(ctstr::compare(str_a::str(), str_b::str()) == 0, \"\");\n"; }},
+        {"ctstr_eq_concat", strings, [](size_t n) { // generated strings are compared
+            return string_input(n) +
+            "using ab = ctstr::concat_t<str_a, str_b>;\n"
+            "static_assert(ctstr::eq<ab, ctstr::concat_t<ab::substr_t<0, " + to_s(n/2) + ">, ab::substr_t<" + to_s(n/2) + ", " + to_s(2*n) + ">>>::value, \"\");\n"; }},
+        {"ctstr_string_to_tuple", strings, [](size_t n) {
+            return string_input(n) +
+            "static_assert(std::tuple_size<ctstr::string_to_tuple_t<str_a>>::value == " + to_s(n + 1) + ", \"\");\n"; }},
+        {"ctstr_tuple_to_string", strings, [](size_t n) {
+            std::string chars;
+            for(char c : literal(n).substr(1, n))
+                chars += std::string(chars.empty() ? "" : ",") + "ctstr::char_t<'" + c + "'>";
+            return
+            "using input = std::tuple<" + chars + ",ctstr::char_t<'\\0'>>;\n"
+            "static_assert(ctstr::tuple_to_string_t<input>::length == " + to_s(n) + ", \"\");\n"; }},
+
+        /// ct::math, arithmetics
+        {"math_isqrt", primes, [](size_t n) {
+            return "static_assert(math::isqrt(" + to_s(n) + ") * math::isqrt(" + to_s(n) + ") <= " + to_s(n) + ", \"\");\n"; }},
+        {"math_smallest_divisor", primes, [](size_t n) {
+            return "static_assert(math::smallest_divisor(" + to_s(n) + ") == " + to_s(n) + ", \"\");\n"; }},
+        {"math_gcd", primes, [](size_t n) {
+            return "static_assert(math::gcd(" + to_s(n) + ", " + to_s(n + 2) + ") == 1, \"\");\n"; }},
+        {"math_prime_factors", primes, [](size_t n) {
+            return "static_assert(math::prime_factors<" + to_s(n) + ">::values[0] == " + to_s(n) + ", \"\");\n"; }},
+        {"math_rho_prime_factors", primes, [](size_t n) {
+            return "static_assert(math::rho::prime_factors<" + to_s(n) + ">::values[0] == " + to_s(n) + ", \"\");\n"; }},
+
+        /// ct::tree
+        {"tree_insert_tuple", trees, [](size_t n) {
+            return tree_input(n) +
+            "static_assert(tree::height<tree_t>::value >= 1, \"\");\n"; }},
+        {"tree_insert_tuple_sorted", trees, [](size_t n) {
+            return tree_input(n, false) +
+            "static_assert(tree::height<tree_t>::value == " + to_s(n) + ", \"\");\n"; }},
+        {"tree_walk", trees, [](size_t n) {
+            return tree_input(n) +
+            "static_assert(std::is_same<tree::walk_t<tree_t>, " + num_list(n) + ">::value, \"\");\n"; }},
+        {"tree_level_walk", trees, [](size_t n) { // complete trees only, N-1 nodes
+            std::vector<size_t> ks;
+            balanced_order(0, n - 1, ks);
+            return tree_input(ks) +
+            "static_assert(std::tuple_size<tree::level_walk_t<tree_t>>::value == " + to_s(n - 1) + ", \"\");\n"; }},
+        {"tree_search", trees, [](size_t n) {
+            return tree_input(n) +
+            "template <typename Acc, typename T> struct finder {\n"
+            "    using type = math::num_t<Acc::value + !std::is_same<tree::search_t<tree_t, T>, tree::NIL>::value>; };\n"
+            "static_assert(tuple_reduce_t<input, finder, math::num_t<0>>::value == " + to_s(n) + ", \"\");\n"; }},
+        {"tree_parent_of", trees, [](size_t n) {
+            return tree_input(n) +
+            "using found = tree::search_t<tree_t, math::num_t<" + to_s(n - 1) + ">>;\n"
+            "static_assert(!std::is_same<tree::parent_of_t<tree_t, found>, int>::value, \"\");\n"; }},
+        {"tree_min_node", trees, [](size_t n) {
+            return tree_input(n) +
+            "static_assert(tree::min_node_t<tree_t>::type::value == 0, \"\");\n"; }},
+        {"tree_remove_tuple", trees, [](size_t n) {
+            return tree_input(n) +
+            "using removed = tree::remove_tuple_t<tree_t, tuple_take_t<input, " + to_s(n/2) + ">>;\n"
+            "static_assert(std::tuple_size<tree::walk_t<removed>>::value == " + to_s(n - n/2) + ", \"\");\n"; }},
+        {"tree_avl_insert_tuple", trees, [](size_t n) {
+            return tree_input(n, true, "tree::avl::insert_tuple_t<tree::NIL, ") +
+            "static_assert(tree::avl::is_balanced<tree_t>::value, \"\");\n"; }},
+        {"tree_avl_insert_tuple_sorted", trees, [](size_t n) {
+            return tree_input(n, false, "tree::avl::insert_tuple_t<tree::NIL, ") +
+            "static_assert(tree::avl::is_balanced<tree_t>::value, \"\");\n"; }},
+        {"tree_avl_remove_tuple", trees, [](size_t n) {
+            return tree_input(n, true, "tree::avl::insert_tuple_t<tree::NIL, ") +
+            "using removed = tree::avl::remove_tuple_t<tree_t, tuple_take_t<input, " + to_s(n/2) + ">>;\n"
+            "static_assert(tree::avl::is_balanced<removed>::value, \"\");\n"; }},
+        {"tree_btree_insert_tuple", trees, [](size_t n) {
+            return tree_input(n, true, "tree::insert_tuple_t<tree::btree<16, num_comp>, ") +
+            "static_assert(tree::height<tree_t>::value >= 1, \"\");\n"; }},
+        {"tree_btree_insert_tuple_sorted", trees, [](size_t n) {
+            return tree_input(n, false, "tree::insert_tuple_t<tree::btree<16, num_comp>, ") +
+            "static_assert(tree::height<tree_t>::value >= 1, \"\");\n"; }},
+        {"tree_btree64_insert_tuple", trees, [](size_t n) {
+            return tree_input(n, true, "tree::insert_tuple_t<tree::btree<64, num_comp>, ") +
+            "static_assert(tree::height<tree_t>::value >= 1, \"\");\n"; }},
+        {"tree_btree_search", trees, [](size_t n) {
+            return tree_input(n, true, "tree::insert_tuple_t<tree::btree<16, num_comp>, ") +
+            "template <typename Acc, typename T> struct finder {\n"
+            "    using type = math::num_t<Acc::value + !std::is_same<tree::search_t<tree_t, T>, tree::NIL>::value>; };\n"
+            "static_assert(tuple_reduce_t<input, finder, math::num_t<0>>::value == " + to_s(n) + ", \"\");\n"; }},
+        {"tree_btree_remove_tuple", trees, [](size_t n) {
+            return tree_input(n, true, "tree::insert_tuple_t<tree::btree<16, num_comp>, ") +
+            "using removed = tree::remove_tuple_t<tree_t, tuple_take_t<input, " + to_s(n/2) + ">>;\n"
+            "static_assert(std::tuple_size<tree::walk_t<removed>>::value == " + to_s(n - n/2) + ", \"\");\n"; }},
+        {"tree_build_balanced", trees, [](size_t n) {
+            return tree_input(n, false, "tree::build_balanced_t<") +
+            "static_assert(tree::height<tree_t>::value <= " + to_s(64 - __builtin_clzll(n)) + ", \"\");\n"; }},
+        {"tree_eytzinger", trees, [](size_t n) {
+            return tree_input(n, false, "tree::build_balanced_t<") +
+            "static_assert(tree::eytzinger_t<tree_t>::values[0] == " + to_s(n/2) + ", \"\");\n"; }},
+        {"tree_dispatch", trees, [](size_t n) { // sparse keys: comparison tree
+            std::vector<size_t> ks(n);
+            for(size_t i = 0; i < n; ++i)
+                ks[i] = 2*i;
+            return tree_input(ks, "tree::build_balanced_t<") +
+            "struct sink { template <typename T> void operator()(identity<T>) const {} };\n"
+            "bool dispatch(size_t key) { return tree::dispatch<tree_t>(key, sink{}); }\n"; }},
+        {"tree_dispatch_dense", trees, [](size_t n) {
+            return tree_input(n, false, "tree::build_balanced_t<") +
+            "struct sink { template <typename T> void operator()(identity<T>) const {} };\n"
+            "bool dispatch(size_t key) { return tree::dispatch<tree_t>(key, sink{}); }\n"; }},
+        {"tree_merge_sort", trees, [](size_t n) {
+            return
+            "struct num_comp : tree::eq_traits<math::num_less> {};\n"
+            "using input = " + num_list(n, true) + ";\n"
+            "static_assert(std::is_same<tree::merge_sort_t<input, num_comp>, " + num_list(n) + ">::value, \"\");\n"; }},
+        {"tree_set_union", trees, [](size_t n) {
+            return set_input(n) +
+            "static_assert(std::tuple_size<tree::walk_t<tree::set_union_t<tree_t, other_t>>>::value == " + to_s(n + n/2) + ", \"\");\n"; }},
+        {"tree_set_union_insert_tuple", trees, [](size_t n) { // baseline: other keys are inserted one by one
+            return set_input(n) +
+            "using joined = tree::avl::insert_tuple_t<tree_t, tree::walk_t<other_t>>;\n"
+            "static_assert(std::tuple_size<tree::walk_t<joined>>::value == " + to_s(2*n) + ", \"\");\n"; }},
+        {"tree_set_intersection", trees, [](size_t n) {
+            return set_input(n) +
+            "static_assert(std::tuple_size<tree::walk_t<tree::set_intersection_t<tree_t, other_t>>>::value == " + to_s(n - n/2) + ", \"\");\n"; }},
+        {"tree_set_symmetric_difference", trees, [](size_t n) {
+            return set_input(n) +
+            "static_assert(std::tuple_size<tree::walk_t<tree::set_symmetric_difference_t<tree_t, other_t>>>::value == " + to_s(2*(n/2)) + ", \"\");\n"; }},
+        {"tree_rank", trees, [](size_t n) { // dense ids of all keys
+            return tree_input(n, true, "tree::avl::insert_tuple_t<tree::NIL, ") +
+            "template <typename Acc, typename T> struct summator {\n"
+            "    using type = math::num_t<Acc::value + tree::rank_t<tree_t, T>::value>; };\n"
+            "static_assert(tuple_reduce_t<input, summator, math::num_t<0>>::value == " + to_s(n*(n - 1)/2) + ", \"\");\n"; }},
+        {"tree_select", trees, [](size_t n) {
+            return tree_input(n, true, "tree::avl::insert_tuple_t<tree::NIL, ") +
+            "template <typename Acc, typename T> struct summator {\n"
+            "    using type = math::num_t<Acc::value + tree::select_t<tree_t, T::value>::type::value>; };\n"
+            "static_assert(tuple_reduce_t<input, summator, math::num_t<0>>::value == " + to_s(n*(n - 1)/2) + ", \"\");\n"; }},
+        {"tree_range_walk", trees, [](size_t n) { // 16 keys from the middle
+            return tree_input(n, true, "tree::avl::insert_tuple_t<tree::NIL, ") +
+            "using found = tree::range_walk_t<tree_t, math::num_t<" + to_s(n/2) + ">, math::num_t<" + to_s(n/2 + 16) + ">>;\n"
+            "static_assert(std::tuple_size<found>::value == 16, \"\");\n"; }},
+        {"tree_map_at", trees, [](size_t n) { // every key is looked up
+            return map_input(n) +
+            "template <typename Acc, typename T> struct summator {\n"
+            "    using type = math::num_t<Acc::value + tree::at_t<map_t, T>::value>; };\n"
+            "static_assert(tuple_reduce_t<input, summator, math::num_t<0>>::value == " + to_s(n*(n - 1)) + ", \"\");\n"; }},
+        {"tree_map_linear_lookup", trees, [](size_t n) { // baseline: recursive scan of entries list
+            return map_input(n) +
+            "template <typename K, typename... E> struct lookup;\n"
+            "template <typename K, typename V, typename... E> struct lookup<K, tree::entry<K, V>, E...> { using type = V; };\n"
+            "template <typename K, typename H, typename... E> struct lookup<K, H, E...> : lookup<K, E...> {};\n"
+            "template <typename K, typename Entries> struct find_in;\n"
+            "template <typename K, typename... E> struct find_in<K, std::tuple<E...>> : lookup<K, E...> {};\n"
+            "template <typename Acc, typename T> struct summator {\n"
+            "    using type = math::num_t<Acc::value + find_in<T, entries>::type::value>; };\n"
+            "static_assert(tuple_reduce_t<input, summator, math::num_t<0>>::value == " + to_s(n*(n - 1)) + ", \"\");\n"; }},
+        {"tree_map_insert_or_assign", trees, [](size_t n) {
+            return map_input(n) +
+            "template <typename Acc, typename T> struct assigner { using type = tree::insert_or_assign_t<Acc, T, void>; };\n"
+            "using assigned = tuple_reduce_t<input, assigner, map_t>;\n"
+            "static_assert(std::is_same<tree::at_t<assigned, math::num_t<0>>, void>::value, \"\");\n"; }},
+        {"tree_type_comp_avl_insert_tuple", trees, [](size_t n) { // same keys as tree_avl_insert_tuple, ordered by names
+            return
+            "using input = " + num_list(keys(n, true)) + ";\n"
+            "using tree_t = tree::avl::insert_tuple_t<tree::NIL, input, tree::type_comp>;\n"
+            "static_assert(tree::size<tree_t>::value == " + to_s(n) + " && tree::avl::is_balanced<tree_t>::value, \"\");\n"; }},
+    };
+    return list;
+}
+
+
+/// --- Measurement --- ///
+
+struct options {
+    std::string cxx = "c++";
+    std::string compiler_id = "GNU";
+    std::string include = "include";
+    std::string out;            // default: compile_bench/ next to the runner, i.e. in the build tree
+    std::string csv;
+    std::string filter;
+    std::string flags = "-std=c++11";
+    size_t max_size = 0;        // 0 - unlimited
+    unsigned timeout = 120;     // CPU seconds per compilation
+    size_t memory_limit = 0;    // MB, 0 - unlimited
+};
+
+struct measurement {
+    std::string status;
+    double wall_s = 0;
+    long peak_rss_kb = 0;
+    std::string inst_count;     // empty if not available
+    std::string inst_time_s;    // empty if not available
+};
+
+std::vector<std::string> split(std::string const& s) {
+    std::vector<std::string> result;
+    std::istringstream in(s);
+    for(std::string word; in >> word; )
+        result.push_back(word);
+    return result;
+}
+
+std::string read_file(std::string const& path) {
+    std::ifstream in(path);
+    std::ostringstream out;
+    out << in.rdbuf();
+    return out.str();
+}
+
+size_t count_occurrences(std::string const& text, std::string const& pattern) {
+    size_t result = 0;
+    for(auto pos = text.find(pattern); pos != std::string::npos; pos = text.find(pattern, pos + 1))
+        ++result;
+    return result;
+}
+
+/// Extracts wall time of "template instantiation" phase from gcc -ftime-report output
+std::string gcc_instantiation_time(std::string const& report) {
+    auto pos = report.find(" template instantiation");
+    if(pos == std::string::npos)
+        return "";
+    auto colon = report.find(':', pos);
+    auto line = report.substr(colon + 1, report.find('\n', colon) - colon - 1);
+
+    // usr ( %) sys ( %) wall ( %) mem ( %)
+    std::vector<std::string> numbers;
+    for(auto& word : split(line))
+        if(!word.empty() && (isdigit(word[0]) || word[0] == '.'))
+            numbers.push_back(word);
+    return numbers.size() >= 3 ? numbers[2] : "";
+}
+
+/// Runs compiler with CPU/memory limits applied to the whole process tree
+measurement compile(options const& opt, std::string const& source, std::string const& object) {
+    std::vector<std::string> args = {opt.cxx};
+    for(auto& f : split(opt.flags))
+        args.push_back(f);
+    args.insert(args.end(), {"-I" + opt.include, "-c", source, "-o", object});
+
+    bool clang = opt.compiler_id.find("Clang") != std::string::npos;
+    if(clang)
+        args.insert(args.end(), {"-ftime-trace", "-ftime-trace-granularity=0"});
+    else
+        args.push_back("-ftime-report");
+
+    auto log = object + ".log";
+    auto start = std::chrono::steady_clock::now();
+
+    pid_t pid = fork();
+    if(pid == 0) {
+        int fd = open(log.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        dup2(fd, STDOUT_FILENO);
+        dup2(fd, STDERR_FILENO);
+
+        rlimit cpu{opt.timeout, opt.timeout};
+        setrlimit(RLIMIT_CPU, &cpu);
+        if(opt.memory_limit > 0) {
+            rlimit mem{opt.memory_limit << 20, opt.memory_limit << 20};
+            setrlimit(RLIMIT_AS, &mem);
+        }
+
+        std::vector<char*> argv;
+        for(auto& a : args)
+            argv.push_back(const_cast<char*>(a.c_str()));
+        argv.push_back(nullptr);
+        execvp(argv[0], argv.data());
+        _exit(127);
+    }
+
+    measurement result;
+    int status = 0;
+    rusage usage{};
+    if(pid < 0 || wait4(pid, &status, 0, &usage) < 0) {
+        result.status = "exec_failed";
+        return result;
+    }
+
+    result.wall_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    result.peak_rss_kb = usage.ru_maxrss;
+
+    double cpu_s = usage.ru_utime.tv_sec + usage.ru_stime.tv_sec +
+                   (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) * 1e-6;
+
+    if(WIFEXITED(status) && WEXITSTATUS(status) == 0)
+        result.status = "ok";
+    else if(WIFEXITED(status) && WEXITSTATUS(status) == 127)
+        result.status = "exec_failed";
+    else
+        result.status = (cpu_s + 1 >= opt.timeout) ? "timeout" : "error";
+
+    if(result.status == "ok") {
+        if(clang) {
+            auto trace = read_file(object.substr(0, object.rfind('.')) + ".json");
+            result.inst_count = std::to_string(
+                count_occurrences(trace, "\"name\":\"InstantiateClass\"") +
+                count_occurrences(trace, "\"name\":\"InstantiateFunction\""));
+        } else {
+            result.inst_time_s = gcc_instantiation_time(read_file(log));
+        }
+    }
+    return result;
+}
+
+options parse(int argc, char** argv) {
+    options opt;
+    for(int i = 1; i + 1 < argc; i += 2) {
+        std::string key = argv[i], value = argv[i + 1];
+        if     (key == "--cxx")             opt.cxx = value;
+        else if(key == "--compiler-id")     opt.compiler_id = value;
+        else if(key == "--include")         opt.include = value;
+        else if(key == "--out")             opt.out = value;
+        else if(key == "--csv")             opt.csv = value;
+        else if(key == "--filter")          opt.filter = value;
+        else if(key == "--flags")           opt.flags = value;
+        else if(key == "--max-size")        opt.max_size = std::stoul(value);
+        else if(key == "--timeout")         opt.timeout = std::stoul(value);
+        else if(key == "--memory-limit")    opt.memory_limit = std::stoul(value);
+        else {
+            std::cerr << "unknown option: " << key << std::endl;
+            std::exit(2);
+        }
+    }
+    if(opt.out.empty()) {
+        const std::string self = argv[0];
+        const size_t slash = self.rfind('/');
+        opt.out = (slash == std::string::npos ? std::string(".") : self.substr(0, slash)) + "/compile_bench";
+    }
+    if(opt.csv.empty())
+        opt.csv = opt.out + "/results.csv";
+    return opt;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    auto opt = parse(argc, argv);
+
+    if(system(("mkdir -p '" + opt.out + "'").c_str()) != 0) {
+        std::cerr << "cannot create " << opt.out << std::endl;
+        return 1;
+    }
+
+    std::ofstream csv(opt.csv);
+    csv << "case,size,compiler,status,wall_s,peak_rss_kb,inst_count,inst_time_s" << std::endl;
+
+    for(auto& c : cases()) {
+        if(c.name.find(opt.filter) == std::string::npos)
+            continue;
+
+        bool timed_out = false; // larger inputs of the same case are skipped
+        for(auto n : c.sizes) {
+            if(opt.max_size > 0 && n > opt.max_size)
+                continue;
+            if(timed_out) {
+                csv << c.name << "," << n << "," << opt.compiler_id << ",skipped,,,," << std::endl;
+                continue;
+            }
+
+            auto base = opt.out + "/" + c.name + "_" + std::to_string(n);
+            std::ofstream(base + ".cpp") <<
+                "#include <ax.ct.hpp>\n"
+                "#include <ax.ct.ctstr.hpp>\n"
+                "#include <ax.ct.math.hpp>\n"
+                "#include <ax.ct.tree.hpp>\n"
+                "using namespace ax::ct;\n"
+                "namespace bench {\n" << c.body(n) << "}\n";
+
+            auto m = compile(opt, base + ".cpp", base + ".o");
+            timed_out = (m.status == "timeout");
+
+            csv << c.name << "," << n << "," << opt.compiler_id << "," << m.status << ","
+                << m.wall_s << "," << m.peak_rss_kb << "," << m.inst_count << "," << m.inst_time_s << std::endl;
+            std::cout << c.name << "[" << n << "]: " << m.status << ", "
+                      << m.wall_s << " s, " << m.peak_rss_kb << " KB" << std::endl;
+        }
+    }
+
+    std::cout << "results: " << opt.csv << std::endl;
+    return 0;
+}
@@ -0,0 +1,521 @@
+/**
+ * Runtime benchmark runner (POSIX).
+ * Every case generates its input once and runs each implementation on it repeatedly,
+ * results of all implementations must agree. Best run is written to CSV:
+ *      case,impl,bytes,best_s,gb_per_s
+ *
+ * Usage:
+ *      runtime_bench [--csv <file>] [--filter <substr>] [--size <MB>] [--repeat <n>]
+ */
+
+#ifndef _GNU_SOURCE
+    #define _GNU_SOURCE // memmem
+#endif
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <iterator>
+#include <numeric>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <ax.ct.ctstr.hpp>
+
+namespace {
+
+using std::size_t;
+using namespace ax::ct;
+
+/// --- Inputs generation --- ///
+
+/// Deterministic pseudo-random numbers (LCG), same inputs on every run
+struct lcg {
+    unsigned long long seed = 0x2545F4914F6CDD1DULL;
+
+    unsigned next(unsigned bound) {
+        seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+        return unsigned((seed >> 33) % bound);
+    }
+};
+
+/// Access log of given size, tail is appended as the last line
+std::string log_text(size_t bytes, std::string const& tail) {
+    static const char* levels[] = {"INFO ", "DEBUG", "WARN "};
+    static const char* methods[] = {"GET", "POST", "PUT"};
+    static const char* paths[] = {"/api/v1/items/", "/api/v1/users/", "/static/img/", "/health?id="};
+    static const unsigned statuses[] = {200, 200, 200, 201, 204, 304, 404};
+
+    lcg random;
+    std::string text;
+    text.reserve(bytes + 256);
+
+    char line[256];
+    while(text.size() + tail.size() < bytes) {
+        int length = std::snprintf(line, sizeof(line),
+            "2026-10-17 12:%02u:%02u.%03u %s [worker-%u] %s %s%u status=%u bytes=%u latency_us=%u\n",
+            random.next(60), random.next(60), random.next(1000), levels[random.next(3)], random.next(32),
+            methods[random.next(3)], paths[random.next(4)], random.next(100000),
+            statuses[random.next(7)], random.next(65536), random.next(100000));
+        text.append(line, size_t(length));
+    }
+    text.resize(bytes - tail.size());
+    return text + tail;
+}
+
+/// Space separated tokens: keywords and random identifiers, half each
+std::string tokens(size_t bytes, std::vector<std::string> const& keywords) {
+    lcg random;
+    std::string text;
+    text.reserve(bytes + 64);
+
+    while(text.size() < bytes) {
+        if(random.next(2) == 0) {
+            text += keywords[random.next(unsigned(keywords.size()))];
+        } else {
+            for(size_t i = 0, n = 3 + random.next(10); i < n; ++i)
+                text += char('a' + random.next(26));
+        }
+        text += ' ';
+    }
+    return text;
+}
+
+/// Calls f(token, length) for every space separated token, @returns the sum of results
+template <typename F>
+size_t for_each_token(std::string const& text, F f) {
+    size_t sum = 0;
+    for(char const* p = text.data(), *end = p + text.size(); p < end; ) {
+        char const* space = static_cast<char const*>(std::memchr(p, ' ', size_t(end - p)));
+        if(space == nullptr)
+            space = end;
+        sum += f(p, size_t(space - p));
+        p = space + 1;
+    }
+    return sum;
+}
+
+/// Fixed-shape records "id=<u32> ts=<u64> sym=<1-8 letters>"
+std::string records(size_t bytes) {
+    lcg random;
+    std::string text;
+    text.reserve(bytes + 64);
+
+    char line[64];
+    while(text.size() < bytes) {
+        const unsigned long long ts = 1700000000000000000ULL + (static_cast<unsigned long long>(random.next(1u << 30)) << 20) + random.next(1u << 20);
+        char symbol[9] = {};
+        for(unsigned i = 0, n = 1 + random.next(8); i < n; ++i)
+            symbol[i] = char('A' + random.next(26));
+        int length = std::snprintf(line, sizeof(line), "id=%u ts=%llu sym=%s\n", random.next(1u << 31), ts, symbol);
+        text.append(line, size_t(length));
+    }
+    return text;
+}
+
+/// --- Cases --- ///
+
+/// Implementation returns checksum (position, count, ...) which must be the same for every one
+struct implementation {
+    std::string name;
+    std::function<size_t(std::string const&)> run;
+};
+
+struct bench_case {
+    std::string name;
+    std::function<std::string(size_t)> input;
+    std::vector<implementation> impls;
+};
+
+/// ctstr::searcher against std::string::find, memmem and std::search, needle is at the end of log
+template <typename Literal>
+bench_case search_case(std::string const& name) {
+    using needle = ctstr::string<Literal>;
+    const std::string pattern = needle::to_string();
+
+    return bench_case{"search_" + name, [pattern](size_t bytes) { return log_text(bytes, pattern); }, {
+        {"ctstr::searcher", [](std::string const& hay) {
+            return ctstr::searcher<needle>::find(hay.data(), hay.size()); }},
+        {"std::string::find", [pattern](std::string const& hay) {
+            return hay.find(pattern); }},
+        {"memmem", [pattern](std::string const& hay) {
+            void const* found = memmem(hay.data(), hay.size(), pattern.data(), pattern.size());
+            return found ? size_t(static_cast<char const*>(found) - hay.data()) : size_t(ctstr::npos); }},
+        {"std::search", [pattern](std::string const& hay) {
+            auto found = std::search(hay.begin(), hay.end(), pattern.begin(), pattern.end());
+            return found != hay.end() ? size_t(found - hay.begin()) : size_t(ctstr::npos); }}
+    }};
+}
+
+DEFINE_LITERAL(needle_level, "ERROR");
+DEFINE_LITERAL(needle_status, "status=503");
+DEFINE_LITERAL(needle_request, "GET /api/v1/items/0 status=500 bytes=0");
+DEFINE_LITERAL(needle_char, "#");
+
+/// Keywords of C++ and SQL, the last one is kw_alter
+#define BENCH_KEYWORDS(X) \
+    X(alignas) X(alignof) X(and) X(and_eq) X(asm) X(auto) X(bitand) X(bitor) X(bool) X(break) \
+    X(case) X(catch) X(char) X(char16_t) X(char32_t) X(class) X(compl) X(const) X(constexpr) X(const_cast) \
+    X(continue) X(decltype) X(default) X(delete) X(do) X(double) X(dynamic_cast) X(else) X(enum) X(explicit) \
+    X(export) X(extern) X(false) X(float) X(for) X(friend) X(goto) X(if) X(inline) X(int) \
+    X(long) X(mutable) X(namespace) X(new) X(noexcept) X(not) X(not_eq) X(nullptr) X(operator) X(or) \
+    X(or_eq) X(private) X(protected) X(public) X(register) X(reinterpret_cast) X(return) X(short) X(signed) X(sizeof) \
+    X(static) X(static_assert) X(static_cast) X(struct) X(switch) X(template) X(this) X(thread_local) X(throw) X(true) \
+    X(try) X(typedef) X(typeid) X(typename) X(union) X(unsigned) X(using) X(virtual) X(void) X(volatile) \
+    X(wchar_t) X(while) X(xor) X(xor_eq) X(select) X(from) X(where) X(insert) X(into) X(values) \
+    X(update) X(set) X(join) X(inner) X(outer) X(left) X(right) X(on) X(group) X(by) \
+    X(order) X(having) X(limit) X(offset) X(distinct) X(as) X(is) X(null) X(like) X(between) \
+    X(exists) X(create) X(table) X(index) X(primary) X(key) X(foreign) X(references) X(drop)
+
+#define BENCH_KEYWORD_LITERAL(name) DEFINE_LITERAL(kw_##name, #name);
+BENCH_KEYWORDS(BENCH_KEYWORD_LITERAL)
+DEFINE_LITERAL(kw_alter, "alter");
+
+#define BENCH_KEYWORD_STRING(name) ctstr::string<kw_##name>,
+#define BENCH_KEYWORD_NAME(name) #name,
+
+/// ctstr::perfect_hash against std::unordered_map and binary search of keywords in tokens
+bench_case keyword_case() {
+    using keywords_hash = ctstr::perfect_hash<BENCH_KEYWORDS(BENCH_KEYWORD_STRING) ctstr::string<kw_alter>>;
+    static const char* const names[] = { BENCH_KEYWORDS(BENCH_KEYWORD_NAME) "alter" };
+
+    std::vector<std::string> keywords(std::begin(names), std::end(names));
+
+    std::unordered_map<std::string, size_t> map;
+    for(size_t id = 0; id < keywords.size(); ++id)
+        map.emplace(keywords[id], id);
+
+    std::vector<std::pair<std::string, size_t>> sorted;
+    for(size_t id = 0; id < keywords.size(); ++id)
+        sorted.emplace_back(keywords[id], id);
+    std::sort(sorted.begin(), sorted.end());
+
+    // Checksum: the sum of (id + 1) for keywords
+    return bench_case{"keyword_lookup", [keywords](size_t bytes) { return tokens(bytes, keywords); }, {
+        {"ctstr::perfect_hash", [](std::string const& text) {
+            return for_each_token(text, [](char const* token, size_t n) {
+                size_t id = keywords_hash::lookup(token, n);
+                return id == ctstr::npos ? 0 : id + 1;
+            }); }},
+        {"std::unordered_map", [map](std::string const& text) {
+            return for_each_token(text, [&map](char const* token, size_t n) {
+                auto found = map.find(std::string(token, n));
+                return found == map.end() ? 0 : found->second + 1;
+            }); }},
+        {"binary search", [sorted](std::string const& text) {
+            return for_each_token(text, [&sorted](char const* token, size_t n) {
+                auto less = [](std::pair<std::string, size_t> const& entry, std::pair<char const*, size_t> const& key) {
+                    int c = std::memcmp(entry.first.data(), key.first, std::min(entry.first.size(), key.second));
+                    return c < 0 || (c == 0 && entry.first.size() < key.second);
+                };
+                auto found = std::lower_bound(sorted.begin(), sorted.end(), std::make_pair(token, n), less);
+                return (found != sorted.end() && found->first.size() == n && std::memcmp(found->first.data(), token, n) == 0) ?
+                    found->second + 1 : 0;
+            }); }}
+    }};
+}
+
+#define BENCH_KEYWORD_COMPARE(name) \
+    if(n == sizeof(#name) - 1 && std::memcmp(token, #name, n) == 0) return n + 1;
+
+/// Chain of comparisons, @returns length + 1 of keyword token, 0 otherwise
+size_t compare_keywords(char const* token, size_t n) {
+    BENCH_KEYWORDS(BENCH_KEYWORD_COMPARE)
+    BENCH_KEYWORD_COMPARE(alter)
+    return 0;
+}
+
+#define BENCH_KEYWORD_CASE(name) \
+    case cases::template label<ctstr::string<kw_##name>>(): \
+        return cases::template is<ctstr::string<kw_##name>>(token, n) ? n + 1 : 0;
+
+/// ctstr::string_switch over keywords, @returns length + 1 of keyword token, 0 otherwise
+template <typename Hash>
+size_t switch_keywords(char const* token, size_t n) {
+    using cases = ctstr::string_switch<Hash, BENCH_KEYWORDS(BENCH_KEYWORD_STRING) ctstr::string<kw_alter>>;
+
+    switch(cases::hash(token, n)) {
+        BENCH_KEYWORDS(BENCH_KEYWORD_CASE)
+        BENCH_KEYWORD_CASE(alter)
+        default: return 0;
+    }
+}
+
+/// ctstr::string_switch with every hash against perfect_hash and comparison chain
+bench_case dispatch_case() {
+    using keywords_hash = ctstr::perfect_hash<BENCH_KEYWORDS(BENCH_KEYWORD_STRING) ctstr::string<kw_alter>>;
+    static const char* const names[] = { BENCH_KEYWORDS(BENCH_KEYWORD_NAME) "alter" };
+    std::vector<std::string> keywords(std::begin(names), std::end(names));
+
+    return bench_case{"string_dispatch", [keywords](size_t bytes) { return tokens(bytes, keywords); }, {
+        {"switch ctstr::fnv1a", [](std::string const& text) {
+            return for_each_token(text, switch_keywords<ctstr::fnv1a>); }},
+        {"switch ctstr::xxhash64", [](std::string const& text) {
+            return for_each_token(text, switch_keywords<ctstr::xxhash64>); }},
+        {"switch ctstr::crc32c", [](std::string const& text) {
+            return for_each_token(text, switch_keywords<ctstr::crc32c>); }},
+        {"ctstr::perfect_hash", [](std::string const& text) {
+            return for_each_token(text, [](char const* token, size_t n) {
+                size_t id = keywords_hash::lookup(token, n);
+                return id == ctstr::npos ? 0 : n + 1;
+            }); }},
+        {"memcmp chain", [](std::string const& text) {
+            return for_each_token(text, compare_keywords); }}
+    }};
+}
+
+/// Runtime string hash against the same hash computed byte by byte
+template <typename Hash>
+bench_case hash_case(std::string const& name, size_t (*reference)(std::string const&)) {
+    std::vector<implementation> impls = {
+        {"ctstr::" + name, [](std::string const& text) {
+            return size_t(Hash::runtime_hash(text.data(), text.size())); }}
+    };
+    if(reference != nullptr)
+        impls.push_back({name + " bytewise", reference});
+    return bench_case{"hash_" + name, [](size_t bytes) { return log_text(bytes, ""); }, impls};
+}
+
+/// CRC-32C with lookup table only
+size_t crc32c_bytewise(std::string const& text) {
+    std::uint32_t c = ~std::uint32_t(0);
+    for(char ch : text)
+        c = ctstr::string_hash_impl::crc32c_byte(c, static_cast<unsigned char>(ch));
+    return ~c;
+}
+
+/// Checksum of occurrence: order independent sum over all occurrences
+size_t occurrence(size_t id, size_t offset) {
+    return offset + id + 1;
+}
+
+/// Occurrences of S with ctstr::searcher, pattern after pattern
+template <typename S>
+size_t search_occurrences(std::string const& text, size_t id) {
+    size_t sum = 0;
+    for(size_t from = 0, pos; (pos = ctstr::searcher<S>::find(text.data() + from, text.size() - from)) != ctstr::npos; from += pos + 1)
+        sum += occurrence(id, from + pos);
+    return sum;
+}
+
+template <typename... S, size_t... I>
+size_t search_all(std::string const& text, index_sequence<I...>) {
+    const size_t sums[] = { search_occurrences<S>(text, I)... };
+    return std::accumulate(std::begin(sums), std::end(sums), size_t(0));
+}
+
+/// ctstr::aho_corasick in a single pass against a pass per keyword
+bench_case multi_pattern_case() {
+    using patterns = std::tuple<BENCH_KEYWORDS(BENCH_KEYWORD_STRING) ctstr::string<kw_alter>>;
+    static const char* const names[] = { BENCH_KEYWORDS(BENCH_KEYWORD_NAME) "alter" };
+    std::vector<std::string> keywords(std::begin(names), std::end(names));
+
+    return bench_case{"multi_pattern", [keywords](size_t bytes) { return tokens(bytes, keywords); }, {
+        {"ctstr::aho_corasick", [](std::string const& text) {
+            size_t sum = 0;
+            ctstr::aho_corasick<patterns>::scan(text, [&sum](size_t id, size_t offset) { sum += occurrence(id, offset); });
+            return sum; }},
+        {"ctstr::searcher per keyword", [](std::string const& text) {
+            return search_all<BENCH_KEYWORDS(BENCH_KEYWORD_STRING) ctstr::string<kw_alter>>(text, make_index_sequence_t<std::tuple_size<patterns>::value>{}); }},
+        {"memmem per keyword", [keywords](std::string const& text) {
+            size_t sum = 0;
+            for(size_t id = 0; id < keywords.size(); ++id)
+                for(char const* p = text.data(), *end = p + text.size();
+                    (p = static_cast<char const*>(memmem(p, size_t(end - p), keywords[id].data(), keywords[id].size()))) != nullptr; ++p)
+                    sum += occurrence(id, size_t(p - text.data()));
+            return sum; }}
+    }};
+}
+
+/// Log line of log_text() with bounded strings
+#define BENCH_LOG_FORMAT "2026-10-17 12:%02u:%02u.%03u %.5s [worker-%u] %.4s %.16s%u status=%u bytes=%u latency_us=%u\n"
+
+DEFINE_LITERAL(log_format, BENCH_LOG_FORMAT);
+
+/// Formats a line per 64 input bytes with fields taken from them, checksum of lengths and middle characters
+template <typename Write>
+size_t format_lines(std::string const& text, Write write) {
+    static const char* levels[] = {"INFO ", "DEBUG", "WARN "};
+    static const char* methods[] = {"GET", "POST", "PUT"};
+    static const char* paths[] = {"/api/v1/items/", "/api/v1/users/", "/static/img/", "/health?id="};
+
+    char line[256];
+    size_t sum = 0;
+    for(size_t i = 0; i + 64 <= text.size(); i += 64) {
+        unsigned w[4];
+        std::memcpy(w, text.data() + i, sizeof(w));
+        const size_t n = write(line, w[0] % 60, w[1] % 60, w[2] % 1000, levels[w[3] % 3], w[0] >> 27,
+            methods[(w[1] >> 28) % 3], paths[w[2] >> 30], w[3] % 100000, w[0] % 600, w[1] % 65536, w[2] % 100000);
+        sum += n + static_cast<unsigned char>(line[n / 2]);
+    }
+    return sum;
+}
+
+/// ctstr::format against snprintf
+bench_case format_case() {
+    using line_format = ctstr::format<ctstr::string<log_format>>;
+    static_assert(line_format::max_size <= 256, "");
+
+    return bench_case{"format_log_line", [](size_t bytes) { return log_text(bytes, ""); }, {
+        {"ctstr::format", [](std::string const& text) {
+            return format_lines(text, [](char* out, unsigned m, unsigned s, unsigned ms, char const* level, unsigned worker,
+                                         char const* method, char const* path, unsigned id, unsigned status, unsigned size, unsigned latency) {
+                return line_format::write(out, m, s, ms, level, worker, method, path, id, status, size, latency); }); }},
+        {"snprintf", [](std::string const& text) {
+            return format_lines(text, [](char* out, unsigned m, unsigned s, unsigned ms, char const* level, unsigned worker,
+                                         char const* method, char const* path, unsigned id, unsigned status, unsigned size, unsigned latency) {
+                return size_t(std::snprintf(out, 256, BENCH_LOG_FORMAT, m, s, ms, level, worker, method, path, id, status, size, latency)); }); }}
+    }};
+}
+
+/// Record pattern, the same fields for every implementation
+DEFINE_LITERAL(record_pattern, "id=%u ts=%llu sym=%s");
+
+/// Calls parse(line, length) for every line, sums its checksums
+template <typename Parse>
+size_t parse_lines(std::string const& text, Parse parse) {
+    size_t sum = 0;
+    for(char const* p = text.data(), *end = p + text.size(); p < end;) {
+        char const* eol = static_cast<char const*>(std::memchr(p, '\n', size_t(end - p)));
+        if(eol == nullptr)
+            eol = end;
+        sum += parse(p, size_t(eol - p));
+        p = eol + 1;
+    }
+    return sum;
+}
+
+size_t record_checksum(unsigned id, unsigned long long ts, size_t symbol) {
+    return size_t(id) + size_t(ts) + symbol;
+}
+
+/// ctstr::scanner against sscanf and strtoul/strtoull with literal compares (std::from_chars needs C++17)
+bench_case scan_case() {
+    using record = ctstr::scanner<ctstr::string<record_pattern>>;
+
+    return bench_case{"scan_records", records, {
+        {"ctstr::scanner", [](std::string const& text) {
+            return parse_lines(text, [](char const* line, size_t n) {
+                record::values v;
+                return record::scan(line, n, v) == ctstr::npos ? 0 :
+                    record_checksum(std::get<0>(v), std::get<1>(v), std::get<2>(v).size); }); }},
+        {"sscanf", [](std::string const& text) {
+            return parse_lines(text, [](char const* line, size_t n) {
+                char copy[64], symbol[16];
+                unsigned id = 0;
+                unsigned long long ts = 0;
+                std::memcpy(copy, line, std::min(n, sizeof(copy) - 1));
+                copy[std::min(n, sizeof(copy) - 1)] = '\0';
+                return std::sscanf(copy, "id=%u ts=%llu sym=%15s", &id, &ts, symbol) != 3 ? 0 :
+                    record_checksum(id, ts, std::strlen(symbol)); }); }},
+        {"strtoul/strtoull", [](std::string const& text) {
+            return parse_lines(text, [](char const* line, size_t n) {
+                char* next = nullptr;
+                if(n < 3 || std::memcmp(line, "id=", 3) != 0)
+                    return size_t(0);
+                const unsigned long id = std::strtoul(line + 3, &next, 10);
+                if(std::memcmp(next, " ts=", 4) != 0)
+                    return size_t(0);
+                const unsigned long long ts = std::strtoull(next + 4, &next, 10);
+                if(std::memcmp(next, " sym=", 5) != 0)
+                    return size_t(0);
+                return record_checksum(unsigned(id), ts, size_t(line + n - (next + 5))); }); }}
+    }};
+}
+
+std::vector<bench_case> cases() {
+    return {
+        search_case<needle_level>("rare_word"),
+        search_case<needle_status>("frequent_bytes"),
+        search_case<needle_request>("long_prefix"),
+        search_case<needle_char>("single_char"),
+        keyword_case(),
+        dispatch_case(),
+        hash_case<ctstr::fnv1a>("fnv1a", nullptr),
+        hash_case<ctstr::xxhash64>("xxhash64", nullptr),
+        hash_case<ctstr::crc32c>("crc32c", crc32c_bytewise),
+        multi_pattern_case(),
+        format_case(),
+        scan_case()
+    };
+}
+
+/// --- Runner --- ///
+
+struct options {
+    std::string csv;
+    std::string filter;
+    size_t size_mb = 64;
+    size_t repeat = 5;
+};
+
+options parse(int argc, char** argv) {
+    options opt;
+    for(int i = 1; i + 1 < argc; i += 2) {
+        std::string key = argv[i], value = argv[i + 1];
+        if     (key == "--csv")     opt.csv = value;
+        else if(key == "--filter")  opt.filter = value;
+        else if(key == "--size")    opt.size_mb = std::stoul(value);
+        else if(key == "--repeat")  opt.repeat = std::stoul(value);
+        else {
+            std::cerr << "unknown option: " << key << std::endl;
+            std::exit(2);
+        }
+    }
+    return opt;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    auto opt = parse(argc, argv);
+    const size_t bytes = opt.size_mb << 20;
+
+    std::ofstream csv;
+    if(!opt.csv.empty()) {
+        csv.open(opt.csv);
+        csv << "case,impl,bytes,best_s,gb_per_s" << std::endl;
+    }
+
+    int status = 0;
+    for(auto& c : cases()) {
+        if(c.name.find(opt.filter) == std::string::npos)
+            continue;
+
+        const std::string input = c.input(bytes);
+        size_t expected = 0;
+
+        for(size_t i = 0; i < c.impls.size(); ++i) {
+            auto& impl = c.impls[i];
+
+            double best = 0;
+            size_t result = 0;
+            for(size_t r = 0; r < opt.repeat; ++r) {
+                auto start = std::chrono::steady_clock::now();
+                result = impl.run(input);
+                double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+                best = (r == 0) ? elapsed : std::min(best, elapsed);
+            }
+
+            if(i == 0)
+                expected = result;
+            if(result != expected) {
+                std::cerr << c.name << ": " << impl.name << " returned " << result
+                          << ", expected " << expected << std::endl;
+                status = 1;
+            }
+
+            const double gbps = input.size() / best * 1e-9;
+            if(csv.is_open())
+                csv << c.name << "," << impl.name << "," << input.size() << "," << best << "," << gbps << std::endl;
+            std::printf("%-22s %-20s %8.3f ms %7.2f GB/s\n", c.name.c_str(), impl.name.c_str(), best * 1e3, gbps);
+        }
+    }
+    return status;
+}
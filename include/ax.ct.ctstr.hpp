@@ -1,10 +1,38 @@
 #pragma once
 
+#include <cstdint>
+#include <cstring>
+#include <functional>
 #include <string>
 #include <sstream>
 #include <type_traits>
 #include <utility>
 
+#include <ax.ct.hpp>
+
+/// Vectorized runtime search and hashing, define AX_CT_NO_SIMD to use scalar code only
+#if !defined(AX_CT_NO_SIMD) && defined(__AVX2__)
+    #define AX_CT_CTSTR_AVX2
+#endif
+#if !defined(AX_CT_NO_SIMD) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+    #define AX_CT_CTSTR_SSE2
+#endif
+#if !defined(AX_CT_NO_SIMD) && (defined(__SSE4_2__) || (defined(_MSC_VER) && defined(__AVX__)))
+    #define AX_CT_CTSTR_SSE42
+#endif
+
+#if defined(AX_CT_CTSTR_AVX2)
+    #include <immintrin.h>
+#elif defined(AX_CT_CTSTR_SSE42)
+    #include <nmmintrin.h>
+#elif defined(AX_CT_CTSTR_SSE2)
+    #include <emmintrin.h>
+#endif
+
+#if defined(_MSC_VER) && !defined(__clang__)
+    #include <intrin.h>
+#endif
+
 #define LOG_HEAD "[ct][ctstr]: "
 
 namespace ax { namespace ct {
@@ -17,41 +45,309 @@ namespace ctstr {
     /// Explicitly defined std::string::npos
     enum : npos_type { npos = std::string::npos };
 
-    /// Explicitly defined constexpr strlen()
+    /// Position of the first null-terminator in [lo, hi) or npos, characters are read in order
+    template <typename Char>
+    constexpr size_t find_null(Char const* str, size_t lo, size_t hi);
+    
+    template <typename Char>
+    constexpr size_t find_null_right(Char const* str, size_t left, size_t mid, size_t hi) {
+        return left != npos ? left : find_null(str, mid, hi); }
+    
+    template <typename Char>
+    constexpr size_t find_null(Char const* str, size_t lo, size_t hi) {
+        return
+        (hi - lo == 1) ? (
+            str[lo] == Char{'\0'} ? lo : size_t(npos)
+        ) : (
+            find_null_right(str, find_null(str, lo, lo + (hi - lo)/2), lo + (hi - lo)/2, hi)
+        );
+    }
+    
+    /// Scans blocks of doubling size [from, from + block) until null-terminator is met
+    template <typename Char>
+    constexpr size_t strlen_block(Char const* str, size_t from, size_t block);
+    
+    template <typename Char>
+    constexpr size_t strlen_next(Char const* str, size_t found, size_t from, size_t block) {
+        return found != npos ? found : strlen_block(str, from, block); }
+    
+    template <typename Char>
+    constexpr size_t strlen_block(Char const* str, size_t from, size_t block) {
+        return strlen_next(str, find_null(str, from, from + block), from + block, 2*block); }
+    
+    /// Explicitly defined constexpr strlen(), O(log N) recursion depth
     template <typename Char>
     constexpr size_t strlen(Char const* str) {
-        return *str == Char{'\0'} ? 0 : 1 + strlen(str + 1); }
+        return strlen_block(str, 0, 1); }
 
+    /// First index in [lo, hi) where a and b differ, hi if none; O(log(hi - lo)) depth
+    template <typename Char>
+    constexpr size_t mismatch(Char const* a, Char const* b, size_t lo, size_t hi);
+    
+    template <typename Char>
+    constexpr size_t mismatch_right(Char const* a, Char const* b, size_t left, size_t mid, size_t hi) {
+        return left != mid ? left : mismatch(a, b, mid, hi); }
+    
     template <typename Char>
-    constexpr size_t find_substr_impl(
-        Char const* c, Char const* s,
-        size_t result, size_t offset, size_t pos
-    ) {
+    constexpr size_t mismatch(Char const* a, Char const* b, size_t lo, size_t hi) {
         return
-        (s[offset] == Char{'\0'}) ? ( // matching completed
-            result
+        (hi - lo <= 1) ? (
+            (lo < hi && a[lo] != b[lo]) ? lo : hi
         ) : (
-            (c[pos] == Char{'\0'}) ? ( // end of string
-                npos
-            ) : (
-                (c[pos] == s[offset]) ? ( // symbol, continue (or start if offset == 0)
-                    find_substr_impl(c, s, (offset == 0 ? pos : result), offset + 1, pos + 1)
-                ) : ( // fail, reset
-                    find_substr_impl(c, s, 0, 0, (offset == 0 ? pos + 1 : result + 1))
-                )
-            )
+            mismatch_right(a, b, mismatch(a, b, lo, lo + (hi - lo)/2), lo + (hi - lo)/2, hi)
         );
     }
+    
+    /// Substring search internals: Two-Way algorithm (Crochemore-Perrin) as state machines
+    namespace search_impl {
+        
+    #if __cplusplus >= 201402L
+        /// Runs State::next() until State::done()
+        template <typename State>
+        constexpr State run(State s) {
+            while(!s.done())
+                s = s.next();
+            return s;
+        }
+        
+        template <typename T, typename Less>
+        constexpr void sift_down(T* heap, size_t root, size_t end, Less less) {
+            for(size_t child = 2*root + 1; child < end; root = child, child = 2*root + 1) {
+                if(child + 1 < end && less(heap[child], heap[child + 1]))
+                    ++child;
+                if(!less(heap[root], heap[child]))
+                    return;
+                const T top = heap[root];
+                heap[root] = heap[child];
+                heap[child] = top;
+            }
+        }
+        
+        /// Sorts values[0, n) by less, O(N log N)
+        template <typename T, typename Less>
+        constexpr void heap_sort(T* values, size_t n, Less less) {
+            for(size_t root = n/2; root-- > 0; )
+                sift_down(values, root, n, less);
+            for(size_t end = n; end-- > 1; ) {
+                const T top = values[0];
+                values[0] = values[end];
+                values[end] = top;
+                sift_down(values, 0, end, less);
+            }
+        }
+    #else
+        /// Runs at most steps transitions, O(log(steps)) depth
+        template <typename State>
+        constexpr State run_block(State s, size_t steps) {
+            return s.done() ? s : steps == 1 ? s.next() : run_block(run_block(s, steps/2), steps - steps/2); }
+        
+        /// Runs blocks of doubling size until State::done(), O(log^2 N) depth for N transitions
+        template <typename State>
+        constexpr State run_from(State s, size_t steps) {
+            return s.done() ? s : run_from(run_block(s, steps), 2*steps); }
+        
+        template <typename State>
+        constexpr State run(State s) {
+            return run_from(s, 1); }
+    #endif
+        
+        /// Maximal suffix of x[0, m) for "<" (or ">" if rev) ordering: starts at ms1 - 1, has period p
+        template <typename Char>
+        struct max_suffix {
+            Char const* x;
+            size_t m;
+            bool rev;
+            size_t ms1, j, k, p;
+            
+            constexpr bool done() const { return j + k >= m; }
+            
+            constexpr bool less(Char a, Char b) const { return rev ? b < a : a < b; }
+            
+            constexpr max_suffix next() const {
+                return
+                less(x[j + k], x[ms1 - 1 + k]) ? (
+                    max_suffix{x, m, rev, ms1, j + k, 1, j + k + 1 - ms1}
+                ) : (
+                    x[j + k] == x[ms1 - 1 + k] ? (
+                        k != p ?
+                            max_suffix{x, m, rev, ms1, j, k + 1, p} :
+                            max_suffix{x, m, rev, ms1, j + p, 1, p}
+                    ) : (
+                        max_suffix{x, m, rev, j + 1, j + 1, 1, 1}
+                    )
+                );
+            }
+        };
+        
+        /// Critical factorization of needle: x = x[0, suffix) x[suffix, m)
+        struct factorization {
+            size_t suffix, period;
+            bool periodic;
+        };
+        
+        template <typename Char>
+        constexpr factorization periodicity(Char const* x, size_t m, size_t suffix, size_t period) {
+            return factorization{suffix, period, suffix + period <= m && mismatch(x, x + period, 0, suffix) == suffix}; }
+        
+        template <typename Char>
+        constexpr factorization critical(Char const* x, size_t m, max_suffix<Char> a, max_suffix<Char> b) {
+            return a.ms1 > b.ms1 ? periodicity(x, m, a.ms1, a.p) : periodicity(x, m, b.ms1, b.p); }
+        
+        template <typename Char>
+        constexpr factorization critical(Char const* x, size_t m) {
+            return critical(x, m,
+                run(max_suffix<Char>{x, m, false, 0, 0, 1, 1}),
+                run(max_suffix<Char>{x, m, true,  0, 0, 1, 1})); }
+        
+        /// Two-Way search of x[0, m) in alignments [j, last] of hay, found is npos until match
+        template <typename Char>
+        struct two_way {
+            Char const* hay;
+            Char const* x;
+            size_t m;
+            factorization f;
+            size_t last, j, memory, found;
+            
+            constexpr bool done() const { return found != npos || j > last; }
+            
+            constexpr bool left_matches() const {
+                return f.periodic ?
+                    memory >= f.suffix || mismatch(x, hay + j, memory, f.suffix) == f.suffix :
+                    mismatch(x, hay + j, 0, f.suffix) == f.suffix;
+            }
+            
+            constexpr two_way shift(size_t by, size_t new_memory) const {
+                return two_way{hay, x, m, f, last, j + by, new_memory, npos}; }
+            
+            /// Right part compared up to i
+            constexpr two_way next(size_t i) const {
+                return
+                (i < m) ? (
+                    shift(i - f.suffix + 1, 0)
+                ) : (
+                    left_matches() ?
+                        two_way{hay, x, m, f, last, j, memory, j} :
+                        (f.periodic ? shift(f.period, m - f.period) : shift(ct::max(f.suffix, m - f.suffix) + 1, 0))
+                );
+            }
+            
+            constexpr two_way next() const {
+                return next(mismatch(x, hay + j, f.periodic ? ct::max(f.suffix, memory) : f.suffix, m)); }
+        };
+        
+        /// First occurrence of s[0, m) in c[0, n) starting in [from, to), npos if none
+        template <typename Char>
+        constexpr size_t find_in(Char const* c, Char const* s, size_t from, size_t to, size_t n, size_t m) {
+            return
+            (m == 0) ? (
+                from <= n && from < to ? from : size_t(npos)
+            ) : (
+                (m > n || from > n - m || from >= to) ? size_t(npos) :
+                run(two_way<Char>{c, s, m, critical(s, m), ct::min(n - m, to - 1), from, 0, npos}).found
+            );
+        }
+        
+        /// Counts non-overlapping occurrences starting from pos
+        template <typename Char>
+        struct counter {
+            Char const* c;
+            Char const* s;
+            size_t n, m, pos, count;
+            
+            constexpr bool done() const { return pos == npos; }
+            
+            constexpr counter next(size_t found) const {
+                return counter{c, s, n, m, found == npos ? size_t(npos) : found + m, found == npos ? count : count + 1}; }
+            
+            constexpr counter next() const {
+                return next(find_in(c, s, pos, npos, n, m)); }
+        };
+        
+    } // search_impl
 
-    /// @returns position of the first occurrence, std::string::npos otherwise
+    /// @returns position of the first occurrence, std::string::npos otherwise; O(N + M), Two-Way algorithm
     template <typename Char>
     constexpr size_t find_substr(Char const* c, Char const* s, size_t from = 0) {
-        return find_substr_impl(c, s, 0, 0, from); }
+        return search_impl::find_in(c, s, from, npos, strlen(c), strlen(s)); }
 
-    /// @returns the number of occurrences of substring
+    /// @returns the number of (non-overlapping) occurrences of substring, O(N + M) per occurrence
     template <typename Char>
     constexpr size_t count_substr(Char const* c, Char const* s) {
-        return find_substr(c, s) == npos ? 0 : 1 + count_substr(&c[find_substr(c, s) + strlen(s)], s); }
+        return *s == Char{'\0'} ? 0 : search_impl::run(search_impl::counter<Char>{c, s, strlen(c), strlen(s), 0, 0}).count; }
+
+    namespace search_impl {
+        
+        template <typename, typename>
+        struct append;
+        
+        template <size_t... I, size_t... J>
+        struct append<index_sequence<I...>, index_sequence<J...>> {
+            using type = index_sequence<I..., J...>; };
+        
+        /// Positions of occurrences of P in S starting in [Lo, Hi), halving ranges after the First one
+        template <typename S, typename P, size_t N, size_t M, size_t Lo, size_t Hi,
+            size_t First = find_in(S::str(), P::str(), Lo, Hi, N, M)>
+        struct occurrences {
+        private:
+            enum : size_t { mid = First + 1 + (Hi - First - 1)/2 };
+        public:
+            using type = typename append<
+                index_sequence<First>,
+                typename append<
+                    typename occurrences<S, P, N, M, First + 1, mid>::type,
+                    typename occurrences<S, P, N, M, mid, Hi>::type
+                >::type
+            >::type;
+        };
+        
+        template <typename S, typename P, size_t N, size_t M, size_t Lo, size_t Hi>
+        struct occurrences<S, P, N, M, Lo, Hi, size_t(npos)> { using type = index_sequence<>; };
+        
+        template <typename Positions>
+        struct positions_array;
+        
+        template <size_t... I>
+        struct positions_array<index_sequence<I...>> {
+            enum : size_t { size = sizeof...(I) };
+            static constexpr size_t values[] = { I..., size_t(npos) };
+        };
+        
+        template <size_t... I>
+        constexpr size_t positions_array<index_sequence<I...>>::values[];
+        
+    } // search_impl
+
+    /**
+     * Finds all (possibly overlapping) occurrences of P in S (literal wrappers or strings), O(log N) depth
+     * Contains:
+     *      size    - the number of occurrences
+     *      values  - ascending positions terminated by npos
+     */
+    template <typename S, typename P>
+    struct find_all : search_impl::positions_array<typename search_impl::occurrences<
+        S, P, strlen(S::str()), strlen(P::str()), 0, strlen(S::str()) + 1
+    >::type> {};
+
+    template <typename Char>
+    constexpr int compare_at(Char const* a, Char const* b, size_t pos, size_t end) {
+        using UChar = typename std::make_unsigned<Char>::type;
+        return pos == end ? 0 : (UChar(a[pos]) < UChar(b[pos]) ? -1 : 1);
+    }
+    
+    /// Lexicographical comparison of first n characters, null-terminators take part
+    template <typename Char>
+    constexpr int compare_n(Char const* a, Char const* b, size_t n) {
+        return compare_at(a, b, mismatch(a, b, 0, n), n); }
+    
+    /// @returns negative, zero or positive value if a is less, equal or greater than b
+    template <typename Char>
+    constexpr int compare(Char const* a, Char const* b) {
+        return compare_n(a, b, ct::min(strlen(a), strlen(b)) + 1); }
+    
+    /// @returns true if strings are equal
+    template <typename Char>
+    constexpr bool equal(Char const* a, Char const* b) {
+        return compare(a, b) == 0; }
 
     
     /// --- Literals --- ///
@@ -88,6 +384,32 @@ namespace ctstr {
     template <typename>
     struct subset_to_tuple;
 
+    /// Literal of Source::at(I)... characters (adds null-terminator) stored in single static array
+    template <typename Source, typename Indices = make_index_sequence_t<Source::length>>
+    struct indexed_literal;
+
+    /// Length and characters of literal wrapper T, scanned through T::str()
+    template <typename T>
+    struct literal_access {
+        using CharT = typename T::CharT;
+        
+        enum : size_t { length = strlen(T::str()) };
+        
+        constexpr static CharT at(size_t idx) {
+            return T::str()[idx]; }
+    };
+
+    /// Generated literals are read from their sources: compilers access instantiated arrays slowly
+    template <typename Source, typename Indices>
+    struct literal_access<indexed_literal<Source, Indices>> {
+        using CharT = typename Source::CharT;
+        
+        enum : size_t { length = Source::length };
+        
+        constexpr static CharT at(size_t idx) {
+            return idx < length ? Source::at(idx) : CharT{'\0'}; }
+    };
+
     /// Unpacks full string to tuple (with null-terminator)
     template <typename>
     struct string_to_tuple;
@@ -102,7 +424,7 @@ namespace ctstr {
     template <typename T>
     using tuple_to_string_t = typename tuple_to_string<T>::type;
 
-    /// Constructs string with character types values ("char" supported)
+    /// Text of values of tuple types separated by ',' (see value_text), computed at compile time
     template <typename>
     struct tuple_printer;
 
@@ -116,7 +438,7 @@ namespace ctstr {
         template <CharT C>
         using xchar_t = basic_char_t<CharT, C>;
         
-        enum : size_t { length = strlen(T::str()) };
+        enum : size_t { length = literal_access<T>::length };
         
         /// Equivalent of full string
         using main_subset = subset<string, 0, length>;
@@ -127,7 +449,7 @@ namespace ctstr {
         
         /// @returns character by index
         constexpr static CharT const at(size_t idx) {
-            return main_subset::at(idx); }
+            return literal_access<T>::at(idx); }
         
         static std_string to_string() {
             return main_subset::to_string(); }
@@ -136,9 +458,7 @@ namespace ctstr {
         template <size_t from, size_t to>
         struct substr {
             static_assert(from <= to && to <= length, LOG_HEAD "invalid substring bounds");
-            using type = typename tuple_to_string<
-                typename subset_to_tuple<subset<string, from, to>>::type
-            >::type;
+            using type = string<indexed_literal<subset<string, from, to>>>;
         };
         
         template <size_t from, size_t to>
@@ -165,52 +485,67 @@ namespace ctstr {
         
         /// @returns character by index
         constexpr static CharT const at(size_t idx) {
-            return base::str()[alpha + idx]; }
+            return base::at(alpha + idx); }
         
         static std_string to_string() {
             return std_string(&(base::str()[alpha]), length); }
     };
 
-    /// Concatenates two strings into new type
+    /// Concatenates two strings into new type backed by single array, O(1) instantiations
     template <typename S1, typename S2>
     struct concat {
-        using type = tuple_to_string_t<tuple_concat_t<
-            tuple_transform_t<string_to_tuple_t<S1>,0,S1::length>,
-            string_to_tuple_t<S2>
-        >>;
+        /// Characters of S1 followed by characters of S2
+        struct source {
+            using CharT = typename S1::CharT;
+            
+            enum : size_t { length = S1::length + S2::length };
+            
+            constexpr static CharT at(size_t idx) {
+                return idx < S1::length ? S1::at(idx) : S2::at(idx - S1::length); }
+        };
+        
+        using type = string<indexed_literal<source>>;
     };
 
     template <typename S1, typename S2>
     using concat_t = typename concat<S1,S2>::type;
 
-    /// Checks two strings equality
+    /// First index in [lo, hi) where characters of S1 and S2 differ, hi if none
     template <typename S1, typename S2>
-    struct eq : std::integral_constant<bool,
-        std::is_same<string_to_tuple_t<S1>,string_to_tuple_t<S2>>::value> {};
+    constexpr size_t strings_mismatch(size_t lo, size_t hi);
+    
+    template <typename S1, typename S2>
+    constexpr size_t strings_mismatch_right(size_t left, size_t mid, size_t hi) {
+        return left != mid ? left : strings_mismatch<S1, S2>(mid, hi); }
+    
+    template <typename S1, typename S2>
+    constexpr size_t strings_mismatch(size_t lo, size_t hi) {
+        return
+        (hi - lo <= 1) ? (
+            (lo < hi && S1::at(lo) != S2::at(lo)) ? lo : hi
+        ) : (
+            strings_mismatch_right<S1, S2>(strings_mismatch<S1, S2>(lo, lo + (hi - lo)/2), lo + (hi - lo)/2, hi)
+        );
+    }
 
-    template <typename S, size_t I>
-    struct subset_to_tuple< subset<S,I,I> > {
-        using CharT = typename S::CharT;
-        
-        template <CharT C>
-        using xchar_t = basic_char_t<CharT, C>;
-        
-        using type = std::tuple< xchar_t<CharT{'\0'}> >;
-    };
+    /// Checks two strings equality, O(1) instantiations
+    template <typename S1, typename S2>
+    struct eq : std::integral_constant<bool,
+        (S1::length == S2::length) && strings_mismatch<S1, S2>(0, S1::length) == S1::length> {};
 
+    /// Expands all characters at once, O(log N) depth and O(N) instantiations
     template <typename S, size_t A, size_t O>
     struct subset_to_tuple< subset<S,A,O> > {
+    private:
         using CharT = typename S::CharT;
-        
-        template <CharT C>
-        using xchar_t = basic_char_t<CharT, C>;
-        
         using sub = subset<S,A,O>;
         
-        using type = tuple_concat_t<
-            std::tuple< xchar_t<sub::at(0)> >,
-            typename subset_to_tuple< typename sub::template slice_t<1, sub::length> >::type
-        >;
+        template <size_t... I>
+        static auto unpack(index_sequence<I...>) ->
+        std::tuple< basic_char_t<CharT, sub::at(I)>..., basic_char_t<CharT, CharT{'\0'}> >;
+        
+    public:
+        using type = decltype(unpack(make_index_sequence_t<sub::length>{}));
     };
 
     /// Creates tuple of symbol classes from given string
@@ -218,26 +553,68 @@ namespace ctstr {
     struct string_to_tuple {
         using type = typename subset_to_tuple<typename S::main_subset>::type; };
 
-    template <>
-    struct tuple_printer<std::tuple<>> { static std::string const print() { return ""; } };    
-
-    template <typename T>
-    struct tuple_printer<std::tuple<T>> {
-        static std::string const print() {
-            std::ostringstream stream;
-            stream << T::value;
-            return stream.str();
-        }
-    };
+    namespace tuple_printer_impl {
+        
+        /// Text of L, separator and text of R
+        template <typename L, typename R>
+        struct joined {
+            using CharT = char;
+            
+            enum : size_t { length = L::length + 1 + R::length };
+            
+            constexpr static char at(size_t idx) {
+                return idx < L::length ? L::at(idx) : idx == L::length ? ',' : R::at(idx - L::length - 1); }
+        };
+        
+        template <typename L, typename R>
+        struct join { using type = joined<L, R>; };
+        
+        struct empty {
+            using CharT = char;
+            
+            enum : size_t { length = 0 };
+            
+            constexpr static char at(size_t) { return '\0'; }
+        };
+        
+        /// Every value is printable at compile time (see value_text)
+        template <typename... T>
+        struct all_printable : all_true<value_text_impl::printable<T>::value...> {};
+        
+        /// Texts are joined pairwise: O(log N) depth of character evaluation, single static array
+        template <bool Printable, typename... T>
+        struct printer {
+        private:
+            using texts = tuple_reduce_tree_t<std::tuple<value_text<T>...>, join>;
+            using source = typename std::conditional<sizeof...(T) == 0, empty, texts>::type;
+            using literal = indexed_literal<source>;
+            
+        public:
+            enum : size_t { length = source::length };
+            
+            /// @returns null-terminated text, no runtime formatting
+            constexpr static char const* str() { return literal::str(); }
+            
+            static std::string const print() { return std::string(str(), length); }
+        };
+        
+        /// Other values (e.g. floating point) are streamed at runtime, no str() and length
+        template <typename H, typename... T>
+        struct printer<false, H, T...> {
+            static std::string const print() {
+                std::ostringstream stream;
+                stream << H::value;
+                int expand[] = { 0, ((stream << ',' << T::value), 0)... };
+                (void)expand;
+                return stream.str();
+            }
+        };
+    }
 
-    template <typename H, typename... T>
-    struct tuple_printer<std::tuple<H, T...>> {
-        static std::string const print() {
-            std::ostringstream stream;
-            stream << H::value << ",";
-            return stream.str() + tuple_printer<std::tuple<T...>>::print();
-        }
-    };
+    /// Text of integral and enumeration values is computed at compile time, other values are streamed
+    template <typename... T>
+    struct tuple_printer<std::tuple<T...>> :
+        tuple_printer_impl::printer<tuple_printer_impl::all_printable<T...>::value, T...> {};
 
     template <typename... CT>
     struct tuple_to_string<std::tuple<CT...>> {
@@ -252,103 +629,2273 @@ namespace ctstr {
 
     template <typename... CT>
     constexpr const typename tuple_to_string<std::tuple<CT...>>::CharT tuple_to_string<std::tuple<CT...>>::literal[];
-    
-    
 
-} // ctstr
+    template <typename Source, size_t... I>
+    struct indexed_literal<Source, index_sequence<I...>> {
+        using CharT = typename Source::CharT;
+        
+        static constexpr const CharT literal[sizeof...(I) + 1] = { Source::at(I)..., CharT{'\0'} };
+        
+        static constexpr const CharT* str() { return literal; }
+    };
 
-/// Experimental: compile time regex-to-DFA
-namespace cregex {
-    
-    namespace ctree {
-        template <typename L, typename T, typename R>
-        struct bintree {
-            using node  = T;
-            using left  = L;
-            using right = R;
+    template <typename Source, size_t... I>
+    constexpr const typename Source::CharT indexed_literal<Source, index_sequence<I...>>::literal[];
+
+    /// --- Runtime search --- ///
+
+    namespace runtime_search_impl {
+        
+        /// Letters of English text ordered by frequency
+        constexpr char const* letters_by_frequency() { return "etaoinsrhldcumfpgwybvkxjqz"; }
+        
+        constexpr unsigned letter_rank(unsigned char c, size_t idx) {
+            return letters_by_frequency()[idx] == char(c) ? 250 - 3*idx : letter_rank(c, idx + 1); }
+        
+        /// Heuristic frequency of byte in text and logs: the higher, the more frequent
+        constexpr unsigned byte_rank(unsigned char c) {
+            return
+            (c == ' ') ? 255 :
+            (c >= 'a' && c <= 'z') ? letter_rank(c, 0) :
+            (c >= '0' && c <= '9') ? 140 :
+            (c >= 'A' && c <= 'Z') ? 100 :
+            (c == ':' || c == '=' || c == '/' || c == '-' || c == '_') ? 120 :
+            (c == '\n' || c == '\t' || c == '.' || c == ',' || c == '"' || c == '(' || c == ')') ? 90 :
+            (c > ' ' && c < 0x7F) ? 60 :
+            (c >= 0x80) ? 30 : 10;
+        }
+        
+        /// Rank of needle character idx as candidate filter, characters equal to skip one are avoided
+        template <typename S>
+        constexpr unsigned filter_rank(size_t idx, size_t skip) {
+            return
+            (idx == skip) ? ~0u :
+            byte_rank(static_cast<unsigned char>(S::at(idx))) + (skip != npos && S::at(idx) == S::at(skip) ? 256 : 0);
+        }
+        
+        template <typename S>
+        constexpr size_t rarer(size_t a, size_t b, size_t skip) {
+            return filter_rank<S>(b, skip) < filter_rank<S>(a, skip) ? b : a; }
+        
+        /// Position of the rarest needle character in [lo, hi) except skip, O(log(hi - lo)) depth
+        template <typename S>
+        constexpr size_t rarest(size_t lo, size_t hi, size_t skip) {
+            return
+            (hi - lo == 1) ? lo :
+            rarer<S>(rarest<S>(lo, lo + (hi - lo)/2, skip), rarest<S>(lo + (hi - lo)/2, hi, skip), skip);
+        }
+        
+        template <size_t Bytes> struct word;
+        template <> struct word<1> { using type = std::uint8_t;  };
+        template <> struct word<2> { using type = std::uint16_t; };
+        template <> struct word<4> { using type = std::uint32_t; };
+        template <> struct word<8> { using type = std::uint64_t; };
+        
+        /// Compares Len characters at Pos with the needle, unrolled into 8/4/2/1-byte words
+        template <typename S, size_t Pos, size_t Len,
+            size_t Step = (Len >= 8 ? 8 : Len >= 4 ? 4 : Len >= 2 ? 2 : Len)>
+        struct unrolled_equal {
+            static bool apply(char const* hay) {
+                typename word<Step>::type h, x;
+                std::memcpy(&h, hay + Pos, Step);
+                std::memcpy(&x, S::str() + Pos, Step);
+                return h == x && unrolled_equal<S, Pos + Step, Len - Step>::apply(hay);
+            }
         };
         
-        template <typename T>
-        using leaf = bintree<void, T, void>;
+        template <typename S, size_t Pos>
+        struct unrolled_equal<S, Pos, 0, 0> {
+            static bool apply(char const*) { return true; } };
         
-        template <typename Tree>
-        struct height;
+        /// Index of the lowest set bit, mask != 0
+        inline unsigned lowest_bit(unsigned mask) {
+        #if defined(_MSC_VER) && !defined(__clang__)
+            unsigned long idx;
+            _BitScanForward(&idx, mask);
+            return unsigned(idx);
+        #else
+            return unsigned(__builtin_ctz(mask));
+        #endif
+        }
         
-        template <typename T>
-        struct height<leaf<T>> : std::integral_constant<size_t, 1> {};
+    #if defined(AX_CT_CTSTR_SSE2)
+        struct sse2 {
+            enum : size_t { width = 16 };
+            using reg = __m128i;
+            
+            static reg splat(char c) { return _mm_set1_epi8(c); }
+            
+            static reg load(char const* p) { return _mm_loadu_si128(reinterpret_cast<reg const*>(p)); }
+            
+            static unsigned both(reg a, reg xa, reg b, reg xb) {
+                return unsigned(_mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(a, xa), _mm_cmpeq_epi8(b, xb)))); }
+        };
+    #endif
         
-        template <typename L, typename T, typename R>
-        struct height<bintree<L,T,R>> : std::integral_constant<size_t,
-            1 + max(height<L>::value, height<R>::value)
-        > {};
-    }
-    
-    using namespace ctstr;
-    
-    /// Nodes opearations
-    enum OPS : int {
-        CONC,   // Concat symbol    (.)
-        UNION,  // Union symbol     (|)
-        ITER    // Iteration symbol (*)
-    };
-    
-    struct OP_CONC : std::integral_constant<int, OPS::CONC>  {};
-    struct OP_UNIN : std::integral_constant<int, OPS::UNION> {};
-    struct OP_ITER : std::integral_constant<int, OPS::ITER>  {};
-    
-    /// Null-terminator (symbol '#')
-    enum : char { TERM = '\0' };
-    
-    template <typename LW, size_t P, char C>
-    struct position {
-        using literal = LW;
-        enum : size_t { pos = P };
-        enum : char { symbol = C };
+    #if defined(AX_CT_CTSTR_AVX2)
+        struct avx2 {
+            enum : size_t { width = 32 };
+            using reg = __m256i;
+            
+            static reg splat(char c) { return _mm256_set1_epi8(c); }
+            
+            static reg load(char const* p) { return _mm256_loadu_si256(reinterpret_cast<reg const*>(p)); }
+            
+            static unsigned both(reg a, reg xa, reg b, reg xb) {
+                return unsigned(_mm256_movemask_epi8(_mm256_and_si256(_mm256_cmpeq_epi8(a, xa), _mm256_cmpeq_epi8(b, xb)))); }
+        };
+    #endif
+        
+        /**
+         * Checks Ops::width alignments at once starting from pos: needle characters at Searcher::rare
+         * and Searcher::second are compared with vector registers, candidates are verified in order.
+         * @returns match position or npos, pos is advanced to the first unchecked alignment
+         */
+        template <typename Ops, typename Searcher>
+        size_t find_blocks(char const* hay, size_t n, size_t& pos) {
+            using reg = typename Ops::reg;
+            
+            const reg rare   = Ops::splat(Searcher::at(Searcher::rare));
+            const reg second = Ops::splat(Searcher::at(Searcher::second));
+            
+            for(; pos + Ops::width + Searcher::length - 1 <= n; pos += Ops::width) {
+                unsigned mask = Ops::both(
+                    Ops::load(hay + pos + Searcher::rare), rare,
+                    Ops::load(hay + pos + Searcher::second), second);
+                
+                for(; mask != 0; mask &= mask - 1) {
+                    const size_t candidate = pos + lowest_bit(mask);
+                    if(Searcher::verify(hay + candidate))
+                        return candidate;
+                }
+            }
+            return npos;
+        }
+        
+        /// Scalar fallback: rarest character is located with memchr, alignments [pos, n - length]
+        template <typename Searcher>
+        size_t find_scalar(char const* hay, size_t n, size_t pos) {
+            const size_t last = n - Searcher::length;
+            
+            while(pos <= last) {
+                void const* rare = std::memchr(hay + pos + Searcher::rare,
+                    static_cast<unsigned char>(Searcher::at(Searcher::rare)), last - pos + 1);
+                if(rare == nullptr)
+                    return npos;
+                
+                const size_t candidate = size_t(static_cast<char const*>(rare) - hay) - Searcher::rare;
+                if(hay[candidate + Searcher::second] == Searcher::at(Searcher::second) && Searcher::verify(hay + candidate))
+                    return candidate;
+                pos = candidate + 1;
+            }
+            return npos;
+        }
+        
+    } // runtime_search_impl
+
+    /**
+     * Runtime substring search of needle S (ctstr::string) specialised at compile time:
+     * two rarest needle characters filter candidates (AVX2/SSE2 when available, memchr otherwise),
+     * candidates are verified with unrolled word comparisons.
+     */
+    template <typename S>
+    struct searcher {
+        using CharT = typename S::CharT;
+        static_assert(sizeof(CharT) == 1, LOG_HEAD "searcher supports single-byte characters only");
+        
+        enum : size_t { length = S::length };
+        
+        /// Filter positions: the rarest character and the rarest one of other values
+        enum : size_t { rare = length == 0 ? 0 : runtime_search_impl::rarest<S>(0, length, npos) };
+        enum : size_t { second = length <= 1 ? rare : runtime_search_impl::rarest<S>(0, length, rare) };
+        
+        /// Characters up to unrolled_limit are compared inline, the rest with memcmp
+        enum : size_t { unrolled_limit = 64 };
+        
+        constexpr static char at(size_t idx) {
+            return static_cast<char>(S::at(idx)); }
+        
+        /// @returns true if needle occurs at hay
+        static bool verify(char const* hay) {
+            return runtime_search_impl::unrolled_equal<S, 0, ct::min(size_t(length), size_t(unrolled_limit))>::apply(hay) && (
+                size_t(length) <= size_t(unrolled_limit) ||
+                std::memcmp(hay + unrolled_limit, S::str() + unrolled_limit, length - unrolled_limit) == 0);
+        }
+        
+        /// @returns position of the first occurrence in hay[0, n), npos otherwise (0 for empty needle)
+        static size_t find(CharT const* hay, size_t n) {
+            char const* bytes = reinterpret_cast<char const*>(hay);
+            
+            if(length == 0)
+                return 0;
+            if(n < length)
+                return npos;
+            
+            size_t pos = 0;
+            size_t found = npos;
+            if(length == 1) // memchr is vectorized already
+                return runtime_search_impl::find_scalar<searcher>(bytes, n, pos);
+        #if defined(AX_CT_CTSTR_AVX2)
+            found = runtime_search_impl::find_blocks<runtime_search_impl::avx2, searcher>(bytes, n, pos);
+            if(found != npos)
+                return found;
+        #endif
+        #if defined(AX_CT_CTSTR_SSE2)
+            found = runtime_search_impl::find_blocks<runtime_search_impl::sse2, searcher>(bytes, n, pos);
+            if(found != npos)
+                return found;
+        #endif
+            (void)found;
+            return runtime_search_impl::find_scalar<searcher>(bytes, n, pos);
+        }
     };
-    
-    /// Alias (L,R ~ syntax_tree, T ~ operation)
-    template <typename L, typename T, typename R>
-    using syntax_tree = ctree::bintree<L, T, R>;
-    
-    /// Leaves contain positions (T ~ position)
-    template <typename T>
-    using syntax_leaf = syntax_tree<void, T, void>;
-    
-    template <typename L, typename>
-    struct tree_hang_left;
-    
-    template <typename L, typename T, typename R>
-    struct tree_hang_left<L, syntax_tree<void, T, R>> {
-        using type = syntax_tree<L, T, R>; };
-    
-    /// ---- nullable --- ///
 
-    template <typename>
-    struct nullable;
-    
-    template <typename T, size_t P>
-    struct nullable<syntax_leaf<position<T,P,TERM>>> : std::true_type {};
-    
-    template <typename T, size_t P, char C>
-    struct nullable<syntax_leaf<position<T,P,C>>> : std::false_type {};
-    
-    template <typename L, typename R>
-    struct nullable<syntax_tree<L,OP_UNIN,R>> : std::integral_constant<bool,
-        nullable<L>::value || nullable<R>::value
-    > {};
-    
-    template <typename L, typename R>
-    struct nullable<syntax_tree<L,OP_CONC,R>> : std::integral_constant<bool,
-        nullable<L>::value && nullable<R>::value
-    > {};
-    
-    template <typename L>
-    struct nullable<syntax_tree<L,OP_ITER,void>> : std::true_type {};
-    
-    /// ---- firstpos --- ///
-    
-    template <typename>
-    struct firstpos;
+    /// --- Perfect hashing --- ///
+
+    namespace perfect_hash_impl {
+        
+        using hash_type = std::uint64_t;
+        
+        constexpr hash_type rotl(hash_type x, unsigned r) { return (x << r) | (x >> (64 - r)); }
+        
+        constexpr hash_type xorshift(hash_type x, unsigned s) { return x ^ (x >> s); }
+        
+        /// MurmurHash3 finalizer
+        constexpr hash_type fmix(hash_type x) {
+            return xorshift(xorshift(xorshift(x, 33) * 0xff51afd7ed558ccdULL, 33) * 0xc4ceb9fe1a85ec53ULL, 33); }
+        
+        /// Hash state after one 8-byte block
+        constexpr hash_type step(hash_type h, hash_type block) {
+            return rotl((h ^ block) * 0x87c37b91114253d5ULL, 31) * 0x4cf5ad432745937fULL; }
+        
+        /// Little-endian word of bytes [i, i + count)
+        template <typename Char>
+        constexpr hash_type load(Char const* s, size_t i, size_t count) {
+            return count == 0 ? 0 : (load(s, i + 1, count - 1) << 8) | hash_type(static_cast<unsigned char>(s[i])); }
+        
+        /// Keys up to 8 bytes are hashed as single block: two overlapping 4-byte words or 3 bytes
+        template <typename Char>
+        constexpr hash_type short_block(Char const* s, size_t n) {
+            return
+            (n >= 4) ? (load(s, 0, 4) << 32) | load(s, n - 4, 4) :
+            (n > 0)  ? (load(s, 0, 1) << 16) | (load(s, n/2, 1) << 8) | load(s, n - 1, 1) : 0;
+        }
+        
+        /// Hashing state of longer keys: 8-byte blocks before i are processed
+        template <typename Char>
+        struct hasher {
+            Char const* s;
+            size_t n, i;
+            hash_type h;
+            
+            constexpr bool done() const { return i + 8 >= n; }
+            
+            constexpr hasher next() const { return hasher{s, n, i + 8, step(h, load(s, i, 8))}; }
+        };
+        
+        /// Hash of key s[0, n): 8-byte blocks, the last one overlaps previous if needed
+        template <typename Char>
+        constexpr hash_type key_hash(Char const* s, size_t n) {
+            return fmix(n <= 8 ?
+                step(0x9e3779b97f4a7c15ULL, short_block(s, n)) ^ n :
+                step(search_impl::run(hasher<Char>{s, n, 0, 0x9e3779b97f4a7c15ULL}).h, load(s, n - 8, 8)) ^ n);
+        }
+        
+        /// Runtime load(), fixed size
+        template <typename Word>
+        inline hash_type load(char const* s) {
+        #if (defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__) || defined(_MSC_VER)
+            Word word;
+            std::memcpy(&word, s, sizeof(Word));
+            return word;
+        #else
+            return load(s, 0, sizeof(Word));
+        #endif
+        }
+        
+        /// Runtime key_hash(), bit-identical
+        inline hash_type runtime_hash(char const* s, size_t n) {
+            hash_type h = 0x9e3779b97f4a7c15ULL;
+            if(n <= 8) {
+                const hash_type block =
+                    (n >= 4) ? (load<std::uint32_t>(s) << 32) | load<std::uint32_t>(s + n - 4) :
+                    (n > 0)  ? (hash_type(static_cast<unsigned char>(s[0])) << 16) |
+                               (hash_type(static_cast<unsigned char>(s[n/2])) << 8) | static_cast<unsigned char>(s[n - 1]) : 0;
+                return fmix(step(h, block) ^ n);
+            }
+            for(size_t i = 0; i + 8 < n; i += 8)
+                h = step(h, load<std::uint64_t>(s + i));
+            return fmix(step(h, load<std::uint64_t>(s + n - 8)) ^ n);
+        }
+        
+        /// Bucket of key among buckets, multiply-shift reduction of the high half
+        constexpr size_t bucket_of(hash_type h, size_t buckets) {
+            return size_t(((h >> 32) * buckets) >> 32); }
+        
+        /// Slot of key inside bucket of k slots for given seed
+        constexpr size_t slot_of(hash_type h, hash_type seed, size_t k) {
+            return size_t(((fmix(h + seed * 0x9e3779b97f4a7c15ULL) & 0xffffffffULL) * k) >> 32); }
+        
+        /// Seeds are searched in [0, seed_limit)
+        enum : size_t { seed_limit = 1 << 16 };
+        
+        struct bucket_entry { std::uint32_t offset, size, seed; };
+        struct slot_entry { hash_type hash; std::uint32_t id; };
+        
+        /**
+         * Hash and displace: N keys are split into N buckets, keys of every bucket are mapped
+         * onto its own slots [offset, offset + size) by the first seed giving a bijection.
+         * Slots of buckets without such seed (e.g. duplicate keys) stay empty: id is ~0.
+         */
+        template <size_t N>
+        struct table {
+            bucket_entry buckets[N];
+            slot_entry slots[N];
+        };
+        
+        constexpr bool all_placed(slot_entry const* slots, size_t lo, size_t hi) {
+            return hi - lo == 1 ? slots[lo].id != ~std::uint32_t(0) : all_placed(slots, lo, lo + (hi - lo)/2) && all_placed(slots, lo + (hi - lo)/2, hi); }
+        
+        /// Every slot is taken: N keys are placed without collisions
+        template <size_t N>
+        constexpr bool complete(table<N> const& t) {
+            return all_placed(t.slots, 0, N); }
+        
+        /// Hashes of keys S..., N == sizeof...(S)
+        template <typename... S>
+        struct key_hashes {
+            enum : size_t { size = sizeof...(S) };
+            static constexpr hash_type values[sizeof...(S)] = { key_hash(S::str(), size_t(S::length))... };
+        };
+        
+        template <typename... S>
+        constexpr hash_type key_hashes<S...>::values[];
+        
+    #if __cplusplus >= 201402L
+        /// Builds table in O(N + seed trials) steps
+        template <typename H>
+        constexpr table<H::size> build() {
+            constexpr size_t n = H::size;
+            table<n> t{};
+            size_t order[n] = {}, cursor[n] = {};
+            
+            for(size_t i = 0; i < n; ++i)
+                ++t.buckets[bucket_of(H::values[i], n)].size;
+            for(size_t b = 1; b < n; ++b)
+                t.buckets[b].offset = cursor[b] = t.buckets[b - 1].offset + t.buckets[b - 1].size;
+            for(size_t i = 0; i < n; ++i)
+                order[cursor[bucket_of(H::values[i], n)]++] = i;
+            for(size_t j = 0; j < n; ++j)
+                t.slots[j].id = ~std::uint32_t(0);
+            
+            for(size_t b = 0; b < n; ++b) {
+                bucket_entry& bucket = t.buckets[b];
+                if(bucket.size > 32)
+                    continue;
+                
+                std::uint64_t mask = 0;
+                for(; bucket.seed < seed_limit; ++bucket.seed) {
+                    mask = 0;
+                    for(size_t j = bucket.offset; j < bucket.offset + bucket.size; ++j) {
+                        const std::uint64_t bit = std::uint64_t(1) << slot_of(H::values[order[j]], bucket.seed, bucket.size);
+                        mask = (mask & bit) ? ~std::uint64_t(0) : mask | bit;
+                    }
+                    if(bucket.size <= 1 || mask == (std::uint64_t(1) << bucket.size) - 1)
+                        break;
+                }
+                if(bucket.seed == seed_limit)
+                    continue;
+                
+                for(size_t j = bucket.offset; j < bucket.offset + bucket.size; ++j) {
+                    slot_entry& slot = t.slots[bucket.offset + slot_of(H::values[order[j]], bucket.seed, bucket.size)];
+                    slot.hash = H::values[order[j]];
+                    slot.id = std::uint32_t(order[j]);
+                }
+            }
+            return t;
+        }
+    #else
+        constexpr size_t count_equal(size_t const* a, size_t v, size_t lo, size_t hi) {
+            return hi - lo == 1 ? (a[lo] == v) : count_equal(a, v, lo, lo + (hi - lo)/2) + count_equal(a, v, lo + (hi - lo)/2, hi); }
+        
+        constexpr size_t sum(size_t const* a, size_t lo, size_t hi) {
+            return hi <= lo ? 0 : hi - lo == 1 ? a[lo] : sum(a, lo, lo + (hi - lo)/2) + sum(a, lo + (hi - lo)/2, hi); }
+        
+        constexpr std::uint64_t merge_slots(std::uint64_t a, std::uint64_t b) {
+            return (a == ~std::uint64_t(0) || b == ~std::uint64_t(0) || (a & b) != 0) ? ~std::uint64_t(0) : a | b; }
+        
+        /// Slots taken by keys [lo, hi) of bucket b as bit mask, all ones on collision
+        template <typename H>
+        constexpr std::uint64_t slots_mask(size_t const* bucket, size_t b, hash_type seed, size_t k, size_t lo, size_t hi) {
+            return
+            (hi - lo == 1) ? (
+                bucket[lo] == b ? std::uint64_t(1) << slot_of(H::values[lo], seed, k) : 0
+            ) : (
+                merge_slots(slots_mask<H>(bucket, b, seed, k, lo, lo + (hi - lo)/2), slots_mask<H>(bucket, b, seed, k, lo + (hi - lo)/2, hi))
+            );
+        }
+        
+        template <typename H>
+        constexpr bool bijective(size_t const* bucket, size_t b, size_t k, size_t seed) {
+            return k <= 32 && slots_mask<H>(bucket, b, seed, k, 0, H::size) == (std::uint64_t(1) << k) - 1; }
+        
+        /// Seed trials of bucket b with k keys, every seed is checked once
+        template <typename H>
+        struct seed_search {
+            size_t const* bucket;
+            size_t b, k, seed;
+            bool found;
+            
+            constexpr bool done() const { return found || seed == seed_limit; }
+            
+            constexpr seed_search next() const {
+                return seed_search{bucket, b, k, seed + 1, bijective<H>(bucket, b, k, seed + 1)}; }
+        };
+        
+        template <typename H>
+        constexpr std::uint32_t bucket_seed(size_t const* bucket, size_t b, size_t k) {
+            return k <= 1 ? 0 : std::uint32_t(search_impl::run(seed_search<H>{bucket, b, k, 0, bijective<H>(bucket, b, k, 0)}).seed); }
+        
+        /**
+         * Construction stages as static arrays: gcc memoizes only shallow constexpr calls,
+         * so every stage is evaluated once
+         */
+        template <typename H, typename Indices = make_index_sequence_t<H::size>>
+        struct layout;
+        
+        template <typename H, size_t... I>
+        struct layout<H, index_sequence<I...>> {
+            /// Bucket of every key
+            static constexpr size_t bucket[sizeof...(I)] = { bucket_of(H::values[I], H::size)... };
+            
+            static constexpr size_t sizes[sizeof...(I)] = { count_equal(bucket, I, 0, H::size)... };
+            
+            static constexpr bucket_entry buckets[sizeof...(I)] = {
+                bucket_entry{std::uint32_t(sum(sizes, 0, I)), std::uint32_t(sizes[I]), bucket_seed<H>(bucket, I, sizes[I])}... };
+            
+            static constexpr size_t position(size_t i, bucket_entry entry) {
+                return entry.offset + slot_of(H::values[i], entry.seed, entry.size); }
+            
+            /// Slot of every key
+            static constexpr size_t positions[sizeof...(I)] = { position(I, buckets[bucket[I]])... };
+        };
+        
+        template <typename H, size_t... I>
+        constexpr size_t layout<H, index_sequence<I...>>::bucket[];
+        
+        template <typename H, size_t... I>
+        constexpr size_t layout<H, index_sequence<I...>>::sizes[];
+        
+        template <typename H, size_t... I>
+        constexpr bucket_entry layout<H, index_sequence<I...>>::buckets[];
+        
+        template <typename H, size_t... I>
+        constexpr size_t layout<H, index_sequence<I...>>::positions[];
+        
+        /// Key placed into slot j among keys [lo, hi), npos if none
+        template <typename L>
+        constexpr size_t key_at(size_t j, size_t lo, size_t hi) {
+            return
+            (hi - lo == 1) ? (
+                L::positions[lo] == j ? lo : size_t(npos)
+            ) : (
+                ct::min(key_at<L>(j, lo, lo + (hi - lo)/2), key_at<L>(j, lo + (hi - lo)/2, hi))
+            );
+        }
+        
+        template <typename H>
+        constexpr slot_entry slot(size_t key) {
+            return key == npos ? slot_entry{0, ~std::uint32_t(0)} : slot_entry{H::values[key], std::uint32_t(key)}; }
+        
+        template <typename H, size_t... I>
+        constexpr table<H::size> build(index_sequence<I...>) {
+            return table<H::size>{
+                { layout<H>::buckets[I]... },
+                { slot<H>(key_at<layout<H>>(I, 0, H::size))... }
+            };
+        }
+        
+        /// Builds table with O(log N) recursion depth and O(N^2) evaluations
+        template <typename H>
+        constexpr table<H::size> build() {
+            return build<H>(make_index_sequence_t<H::size>{}); }
+    #endif
+        
+    } // perfect_hash_impl
+
+    /**
+     * Minimal perfect hash of distinct keys S... (strings or literal wrappers), built at compile time.
+     * Key id is its index in S..., lookup costs one hash and one comparison.
+     */
+    template <typename... S>
+    struct perfect_hash {
+        static_assert(sizeof...(S) > 0, LOG_HEAD "empty key set");
+        
+        using CharT = typename std::tuple_element<0, std::tuple<typename S::CharT...>>::type;
+        static_assert(sizeof(CharT) == 1, LOG_HEAD "perfect_hash supports single-byte characters only");
+        
+        enum : size_t { size = sizeof...(S) };
+        
+        using hashes = perfect_hash_impl::key_hashes<S...>;
+        using table = perfect_hash_impl::table<size>;
+        
+        /// Buckets and slots, static constexpr: no initialization at runtime
+        static constexpr table value = perfect_hash_impl::build<hashes>();
+        static_assert(perfect_hash_impl::complete(value), LOG_HEAD "perfect hash is not found (duplicate keys?)");
+        
+        static constexpr CharT const* keys[size] = { S::str()... };
+        static constexpr size_t lengths[size] = { size_t(S::length)... };
+        
+        /// @returns id of key[0, n), npos if key is not in the set
+        static size_t lookup(CharT const* key, size_t n) {
+            using namespace perfect_hash_impl;
+            
+            const hash_type h = runtime_hash(reinterpret_cast<char const*>(key), n);
+            const bucket_entry& bucket = value.buckets[bucket_of(h, size)];
+            
+            // Empty bucket gives its offset (N at most): hash is compared anyway, no branch
+            const slot_entry& slot = value.slots[ct::min(bucket.offset + slot_of(h, bucket.seed, bucket.size), size_t(size) - 1)];
+            return (slot.hash == h && lengths[slot.id] == n && std::memcmp(keys[slot.id], key, n) == 0) ? slot.id : size_t(npos);
+        }
+        
+        static size_t lookup(std::basic_string<CharT> const& key) {
+            return lookup(key.data(), key.size()); }
+        
+        /// @returns id of null-terminated key at compile time, npos if key is not in the set
+        constexpr static size_t lookup(CharT const* key) {
+            return lookup_slot(key, perfect_hash_impl::key_hash(key, strlen(key))); }
+        
+    private:
+        constexpr static size_t lookup_slot(CharT const* key, perfect_hash_impl::hash_type h) {
+            return lookup_id(key, value.buckets[perfect_hash_impl::bucket_of(h, size)], h); }
+        
+        constexpr static size_t lookup_id(CharT const* key, perfect_hash_impl::bucket_entry bucket, perfect_hash_impl::hash_type h) {
+            return bucket.size == 0 ? size_t(npos) : matching_id(key, value.slots[bucket.offset + perfect_hash_impl::slot_of(h, bucket.seed, bucket.size)]); }
+        
+        constexpr static size_t matching_id(CharT const* key, perfect_hash_impl::slot_entry slot) {
+            return equal(keys[slot.id], key) ? slot.id : size_t(npos); }
+    };
+
+    template <typename... S>
+    constexpr typename perfect_hash<S...>::table perfect_hash<S...>::value;
+
+    template <typename... S>
+    constexpr typename perfect_hash<S...>::CharT const* perfect_hash<S...>::keys[];
+
+    template <typename... S>
+    constexpr size_t perfect_hash<S...>::lengths[];
+
+    /// --- String hashing --- ///
+
+    namespace string_hash_impl {
+        
+        using perfect_hash_impl::hash_type;
+        using perfect_hash_impl::rotl;
+        using perfect_hash_impl::xorshift;
+        using perfect_hash_impl::load;
+        
+        template <typename Char>
+        constexpr hash_type byte(Char c) { return static_cast<unsigned char>(c); }
+        
+        /// FNV-1a: h = (h ^ byte) * prime for every byte
+        enum : hash_type { fnv_basis = 0xcbf29ce484222325ULL, fnv_prime = 0x100000001b3ULL };
+        
+        template <typename Char>
+        constexpr hash_type fnv1a_bytes(hash_type h, Char const* s, size_t i, size_t count) {
+            return count == 0 ? h : fnv1a_bytes((h ^ byte(s[i])) * fnv_prime, s, i + 1, count - 1); }
+        
+        /// FNV-1a state: bytes before i are processed, up to 8 bytes per transition
+        template <typename Char>
+        struct fnv1a_state {
+            Char const* s;
+            size_t n, i;
+            hash_type h;
+            
+            constexpr bool done() const { return i == n; }
+            
+            constexpr fnv1a_state next() const {
+                return fnv1a_state{s, n, i + ct::min(n - i, size_t(8)), fnv1a_bytes(h, s, i, ct::min(n - i, size_t(8)))}; }
+        };
+        
+        /// XXH64: four lanes over 32-byte stripes, then 8, 4 and 1 byte steps of the tail
+        enum : hash_type {
+            xxh_p1 = 0x9e3779b185ebca87ULL, xxh_p2 = 0xc2b2ae3d27d4eb4fULL, xxh_p3 = 0x165667b19e3779f9ULL,
+            xxh_p4 = 0x85ebca77c2b2ae63ULL, xxh_p5 = 0x27d4eb2f165667c5ULL
+        };
+        
+        constexpr hash_type xxh_round(hash_type acc, hash_type input) {
+            return rotl(acc + input * xxh_p2, 31) * xxh_p1; }
+        
+        constexpr hash_type xxh_merge(hash_type h, hash_type lane) {
+            return (h ^ xxh_round(0, lane)) * xxh_p1 + xxh_p4; }
+        
+        constexpr hash_type xxh_avalanche(hash_type h) {
+            return xorshift(xorshift(xorshift(h, 33) * xxh_p2, 29) * xxh_p3, 32); }
+        
+        constexpr hash_type xxh_step8(hash_type h, hash_type word) {
+            return rotl(h ^ xxh_round(0, word), 27) * xxh_p1 + xxh_p4; }
+        
+        constexpr hash_type xxh_step4(hash_type h, hash_type word) {
+            return rotl(h ^ (word * xxh_p1), 23) * xxh_p2 + xxh_p3; }
+        
+        constexpr hash_type xxh_step1(hash_type h, hash_type b) {
+            return rotl(h ^ (b * xxh_p5), 11) * xxh_p1; }
+        
+        /// XXH64 lanes: 32-byte stripes before i are processed
+        template <typename Char>
+        struct xxh_stripes {
+            Char const* s;
+            size_t n, i;
+            hash_type v1, v2, v3, v4;
+            
+            constexpr bool done() const { return i + 32 > n; }
+            
+            constexpr xxh_stripes next() const {
+                return xxh_stripes{s, n, i + 32,
+                    xxh_round(v1, load(s, i, 8)), xxh_round(v2, load(s, i + 8, 8)),
+                    xxh_round(v3, load(s, i + 16, 8)), xxh_round(v4, load(s, i + 24, 8))};
+            }
+            
+            constexpr hash_type converge() const {
+                return xxh_merge(xxh_merge(xxh_merge(xxh_merge(
+                    rotl(v1, 1) + rotl(v2, 7) + rotl(v3, 12) + rotl(v4, 18), v1), v2), v3), v4);
+            }
+        };
+        
+        /// XXH64 tail: bytes before i are processed
+        template <typename Char>
+        struct xxh_tail {
+            Char const* s;
+            size_t n, i;
+            hash_type h;
+            
+            constexpr bool done() const { return i == n; }
+            
+            constexpr xxh_tail next() const {
+                return
+                (n - i >= 8) ? xxh_tail{s, n, i + 8, xxh_step8(h, load(s, i, 8))} :
+                (n - i >= 4) ? xxh_tail{s, n, i + 4, xxh_step4(h, load(s, i, 4))} :
+                               xxh_tail{s, n, i + 1, xxh_step1(h, byte(s[i]))};
+            }
+        };
+        
+        template <typename Char>
+        constexpr hash_type xxh64_lanes(Char const* s, size_t n, hash_type seed) {
+            return n < 32 ? seed + xxh_p5 :
+                search_impl::run(xxh_stripes<Char>{s, n, 0, seed + xxh_p1 + xxh_p2, seed + xxh_p2, seed, seed - xxh_p1}).converge();
+        }
+        
+        template <typename Char>
+        constexpr hash_type xxh64(Char const* s, size_t n, hash_type seed) {
+            return xxh_avalanche(search_impl::run(xxh_tail<Char>{s, n, n - n % 32, xxh64_lanes(s, n, seed) + n}).h); }
+        
+        /// CRC-32C (Castagnoli), reflected polynomial 0x82f63b78
+        constexpr std::uint32_t crc32c_bits(std::uint32_t c, size_t bits) {
+            return bits == 0 ? c : crc32c_bits((c >> 1) ^ ((c & 1u) ? 0x82f63b78u : 0u), bits - 1); }
+        
+        /// CRC-32C of every byte value
+        template <typename Indices = make_index_sequence_t<256>>
+        struct crc32c_table;
+        
+        template <size_t... I>
+        struct crc32c_table<index_sequence<I...>> {
+            static constexpr std::uint32_t values[256] = { crc32c_bits(std::uint32_t(I), 8)... };
+        };
+        
+        template <size_t... I>
+        constexpr std::uint32_t crc32c_table<index_sequence<I...>>::values[256];
+        
+        constexpr std::uint32_t crc32c_byte(std::uint32_t c, hash_type b) {
+            return crc32c_table<>::values[(c ^ b) & 0xffu] ^ (c >> 8); }
+        
+        template <typename Char>
+        constexpr std::uint32_t crc32c_bytes(std::uint32_t c, Char const* s, size_t i, size_t count) {
+            return count == 0 ? c : crc32c_bytes(crc32c_byte(c, byte(s[i])), s, i + 1, count - 1); }
+        
+        /// CRC-32C state: bytes before i are processed, up to 8 bytes per transition
+        template <typename Char>
+        struct crc32c_state {
+            Char const* s;
+            size_t n, i;
+            std::uint32_t c;
+            
+            constexpr bool done() const { return i == n; }
+            
+            constexpr crc32c_state next() const {
+                return crc32c_state{s, n, i + ct::min(n - i, size_t(8)), crc32c_bytes(c, s, i, ct::min(n - i, size_t(8)))}; }
+        };
+        
+        /// Runtime versions, bit-identical
+        inline hash_type runtime_fnv1a(char const* s, size_t n) {
+            hash_type h = fnv_basis;
+            for(size_t i = 0; i < n; ++i)
+                h = (h ^ static_cast<unsigned char>(s[i])) * fnv_prime;
+            return h;
+        }
+        
+        inline hash_type runtime_xxh64(char const* s, size_t n, hash_type seed) {
+            hash_type h = seed + xxh_p5;
+            size_t i = 0;
+            if(n >= 32) {
+                hash_type v1 = seed + xxh_p1 + xxh_p2, v2 = seed + xxh_p2, v3 = seed, v4 = seed - xxh_p1;
+                for(; i + 32 <= n; i += 32) {
+                    v1 = xxh_round(v1, load<std::uint64_t>(s + i));
+                    v2 = xxh_round(v2, load<std::uint64_t>(s + i + 8));
+                    v3 = xxh_round(v3, load<std::uint64_t>(s + i + 16));
+                    v4 = xxh_round(v4, load<std::uint64_t>(s + i + 24));
+                }
+                h = xxh_stripes<char>{s, n, i, v1, v2, v3, v4}.converge();
+            }
+            h += n;
+            for(; i + 8 <= n; i += 8)
+                h = xxh_step8(h, load<std::uint64_t>(s + i));
+            if(i + 4 <= n) {
+                h = xxh_step4(h, load<std::uint32_t>(s + i));
+                i += 4;
+            }
+            for(; i < n; ++i)
+                h = xxh_step1(h, static_cast<unsigned char>(s[i]));
+            return xxh_avalanche(h);
+        }
+        
+        /// SSE4.2 crc32 instruction computes CRC-32C, 8 bytes at once
+        inline std::uint32_t runtime_crc32c(char const* s, size_t n) {
+            std::uint32_t c = ~std::uint32_t(0);
+        #if defined(AX_CT_CTSTR_SSE42) && (defined(__x86_64__) || defined(_M_X64))
+            std::uint64_t wide = c;
+            for(; n >= 8; s += 8, n -= 8)
+                wide = _mm_crc32_u64(wide, load<std::uint64_t>(s));
+            c = std::uint32_t(wide);
+        #elif defined(AX_CT_CTSTR_SSE42)
+            for(; n >= 4; s += 4, n -= 4)
+                c = _mm_crc32_u32(c, std::uint32_t(load<std::uint32_t>(s)));
+        #endif
+            for(; n > 0; ++s, --n)
+                c = crc32c_byte(c, static_cast<unsigned char>(*s));
+            return ~c;
+        }
+        
+    } // string_hash_impl
+
+    /// 64-bit FNV-1a: byte at a time, fast enough for short keys
+    struct fnv1a {
+        using value_type = std::uint64_t;
+        
+        /// @returns hash of s[0, n) at compile time
+        template <typename Char>
+        constexpr static value_type hash(Char const* s, size_t n) {
+            static_assert(sizeof(Char) == 1, LOG_HEAD "string hashes support single-byte characters only");
+            return search_impl::run(string_hash_impl::fnv1a_state<Char>{s, n, 0, string_hash_impl::fnv_basis}).h;
+        }
+        
+        template <typename Char>
+        constexpr static value_type hash(Char const* s) {
+            return hash(s, strlen(s)); }
+        
+        /// @returns hash of s[0, n) at runtime, bit-identical to hash()
+        static value_type runtime_hash(char const* s, size_t n) {
+            return string_hash_impl::runtime_fnv1a(s, n); }
+        
+        static value_type runtime_hash(std::string const& s) {
+            return runtime_hash(s.data(), s.size()); }
+    };
+
+    /// XXH64 with given seed: 8 bytes per step, 32 bytes in four independent lanes for long keys
+    struct xxhash64 {
+        using value_type = std::uint64_t;
+        
+        template <typename Char>
+        constexpr static value_type hash(Char const* s, size_t n, value_type seed = 0) {
+            static_assert(sizeof(Char) == 1, LOG_HEAD "string hashes support single-byte characters only");
+            return string_hash_impl::xxh64(s, n, seed);
+        }
+        
+        template <typename Char>
+        constexpr static value_type hash(Char const* s) {
+            return hash(s, strlen(s)); }
+        
+        static value_type runtime_hash(char const* s, size_t n, value_type seed = 0) {
+            return string_hash_impl::runtime_xxh64(s, n, seed); }
+        
+        static value_type runtime_hash(std::string const& s) {
+            return runtime_hash(s.data(), s.size()); }
+    };
+
+    /// CRC-32C (iSCSI): SSE4.2 crc32 instruction at runtime when available, lookup table otherwise
+    struct crc32c {
+        using value_type = std::uint32_t;
+        
+        template <typename Char>
+        constexpr static value_type hash(Char const* s, size_t n) {
+            static_assert(sizeof(Char) == 1, LOG_HEAD "string hashes support single-byte characters only");
+            return ~search_impl::run(string_hash_impl::crc32c_state<Char>{s, n, 0, ~std::uint32_t(0)}).c;
+        }
+        
+        template <typename Char>
+        constexpr static value_type hash(Char const* s) {
+            return hash(s, strlen(s)); }
+        
+        static value_type runtime_hash(char const* s, size_t n) {
+            return string_hash_impl::runtime_crc32c(s, n); }
+        
+        static value_type runtime_hash(std::string const& s) {
+            return runtime_hash(s.data(), s.size()); }
+    };
+
+    /// Hash (fnv1a, xxhash64, crc32c) of string S computed at compile time
+    template <typename Hash, typename S>
+    struct hash_of : std::integral_constant<typename Hash::value_type, Hash::hash(S::str(), size_t(S::length))> {};
+
+    namespace string_hash_impl {
+        
+        /// Hashes of strings S..., N == sizeof...(S)
+        template <typename Hash, typename... S>
+        struct case_hashes {
+            enum : size_t { size = sizeof...(S) };
+            static constexpr typename Hash::value_type values[sizeof...(S)] = { hash_of<Hash, S>::value... };
+        };
+        
+        template <typename Hash, typename... S>
+        constexpr typename Hash::value_type case_hashes<Hash, S...>::values[];
+        
+    #if __cplusplus >= 201402L
+        /// Sorted copy of values, neighbours are compared: O(N log N)
+        template <size_t N, typename T>
+        constexpr bool distinct(T const* values) {
+            T sorted[N] = {};
+            for(size_t i = 0; i < N; ++i)
+                sorted[i] = values[i];
+            search_impl::heap_sort(sorted, N, std::less<T>());
+            
+            for(size_t i = 1; i < N; ++i)
+                if(sorted[i - 1] == sorted[i])
+                    return false;
+            return true;
+        }
+    #else
+        /// value is in values[lo, hi)
+        template <typename T>
+        constexpr bool contains(T const* values, size_t lo, size_t hi, T value) {
+            return
+            (hi - lo <= 1) ? (
+                lo < hi && values[lo] == value
+            ) : (
+                contains(values, lo, lo + (hi - lo)/2, value) || contains(values, lo + (hi - lo)/2, hi, value)
+            );
+        }
+        
+        /// values[i] for i in [lo, hi) are not repeated in values[i + 1, n)
+        template <typename T>
+        constexpr bool distinct(T const* values, size_t n, size_t lo, size_t hi) {
+            return
+            (hi - lo <= 1) ? (
+                lo == hi || !contains(values, lo + 1, n, values[lo])
+            ) : (
+                distinct(values, n, lo, lo + (hi - lo)/2) && distinct(values, n, lo + (hi - lo)/2, hi)
+            );
+        }
+        
+        /// Pairwise comparison with O(log N) recursion depth and O(N^2) evaluations
+        template <size_t N, typename T>
+        constexpr bool distinct(T const* values) {
+            return distinct(values, N, 0, N); }
+    #endif
+        
+        /// K equals one of strings S...
+        template <typename K, typename... S>
+        struct one_of : any_true<eq<K, S>::value...> {};
+        
+    } // string_hash_impl
+
+    /// True if hashes of strings S... are pairwise different
+    template <typename Hash, typename... S>
+    struct unique_hashes : std::integral_constant<bool,
+        string_hash_impl::distinct<sizeof...(S)>(string_hash_impl::case_hashes<Hash, S...>::values)> {};
+
+    template <typename Hash>
+    struct unique_hashes<Hash> : std::true_type {};
+
+    /**
+     * Dispatch of runtime strings over case strings S...: one hash and one comparison.
+     * Hash collisions among S... are detected at compile time.
+     *      using command = string_switch<fnv1a, str_get, str_put>;
+     *      switch(command::hash(key, n)) {
+     *          case command::label<str_get>(): if(command::is<str_get>(key, n)) ...
+     *      }
+     */
+    template <typename Hash, typename... S>
+    struct string_switch {
+        static_assert(sizeof...(S) > 0, LOG_HEAD "empty case set");
+        static_assert(unique_hashes<Hash, S...>::value, LOG_HEAD "hash collision among case strings, use another hash");
+        
+        using CharT = typename std::tuple_element<0, std::tuple<typename S::CharT...>>::type;
+        using value_type = typename Hash::value_type;
+        
+        /// @returns runtime hash of key[0, n) to switch on
+        static value_type hash(CharT const* key, size_t n) {
+            return Hash::runtime_hash(reinterpret_cast<char const*>(key), n); }
+        
+        static value_type hash(std::basic_string<CharT> const& key) {
+            return hash(key.data(), key.size()); }
+        
+        /// @returns case label of K, one of S...: collisions are checked among them only
+        template <typename K>
+        constexpr static value_type label() {
+            static_assert(string_hash_impl::one_of<K, S...>::value, LOG_HEAD "label of string which is not a case");
+            return hash_of<Hash, K>::value; }
+        
+        /// @returns true if key[0, n) is K: confirms the matched label
+        template <typename K>
+        static bool is(CharT const* key, size_t n) {
+            static_assert(string_hash_impl::one_of<K, S...>::value, LOG_HEAD "check of string which is not a case");
+            return n == size_t(K::length) && std::memcmp(K::str(), key, n) == 0; }
+        
+        template <typename K>
+        static bool is(std::basic_string<CharT> const& key) {
+            return is<K>(key.data(), key.size()); }
+    };
+
+    /// --- Multi-pattern search --- ///
+
+    namespace aho_corasick_impl {
+        
+        /// Patterns S... as arrays, pattern id is its index in S...
+        template <typename... S>
+        struct patterns {
+            enum : size_t { size = sizeof...(S) };
+            static constexpr char const* str[sizeof...(S)] = { S::str()... };
+            static constexpr size_t len[sizeof...(S)] = { size_t(S::length)... };
+        };
+        
+        template <typename... S>
+        constexpr char const* patterns<S...>::str[];
+        
+        template <typename... S>
+        constexpr size_t patterns<S...>::len[];
+        
+        constexpr size_t byte(char c) { return static_cast<unsigned char>(c); }
+        
+        /// Length of common prefix of a[0, n) and b[0, n)
+        constexpr size_t common_prefix(char const* a, char const* b, size_t n) {
+            return n == 0 ? 0 : mismatch(a, b, 0, n); }
+        
+        constexpr bool ordered(int c, size_t i, size_t j) { return c < 0 || (c == 0 && i < j); }
+        
+        /// Pattern i precedes pattern j: lexicographical order, equal patterns by id
+        template <typename P>
+        constexpr bool precedes(size_t i, size_t j) {
+            return ordered(compare_n(P::str[i], P::str[j], ct::min(P::len[i], P::len[j]) + 1), i, j); }
+        
+        constexpr size_t popcount_bytes(std::uint64_t x) {
+            return size_t((((x + (x >> 4)) & 0x0f0f0f0f0f0f0f0fULL) * 0x0101010101010101ULL) >> 56); }
+        
+        constexpr size_t popcount_pairs(std::uint64_t x) {
+            return popcount_bytes((x & 0x3333333333333333ULL) + ((x >> 2) & 0x3333333333333333ULL)); }
+        
+        /// Population count without recursion over bits
+        constexpr size_t popcount(std::uint64_t x) {
+            return popcount_pairs(x - ((x >> 1) & 0x5555555555555555ULL)); }
+        
+        /// The number of bytes below b in bit set
+        constexpr size_t bytes_below(std::uint64_t const* bytes, size_t b) {
+            return
+            (b < 64)  ? popcount(bytes[0] & ((std::uint64_t(1) << b) - 1)) :
+            (b == 64) ? popcount(bytes[0]) :
+                        popcount(bytes[0]) + bytes_below(bytes + 1, b - 64);
+        }
+        
+        constexpr bool has_byte(std::uint64_t const* bytes, size_t b) {
+            return (bytes[b / 64] >> (b % 64)) & 1; }
+        
+        /// Byte class: bytes absent in patterns share class 0, others are numbered from 1
+        constexpr size_t class_of(std::uint64_t const* bytes, size_t b) {
+            return has_byte(bytes, b) ? 1 + bytes_below(bytes, b) : 0; }
+        
+        /**
+         * Patterns in lexicographical order: trie nodes are numbered in depth-first order,
+         * prefix [0, l) of the r-th pattern is node base[r] + l - lcp[r] - 1 if l > lcp[r].
+         * Root is node 0, base[N] is the number of nodes.
+         */
+        template <size_t N>
+        struct shape {
+            size_t order[N];        // pattern id of the r-th pattern
+            size_t lcp[N];          // common prefix with the previous pattern
+            size_t base[N + 1];     // first node added by the r-th pattern
+            std::uint64_t bytes[4]; // bytes of patterns as bit set
+        };
+        
+        /// Trie node of depth l of the r-th pattern, l > lcp[r]
+        template <size_t N>
+        constexpr size_t node_of(shape<N> const& s, size_t r, size_t l) {
+            return s.base[r] + l - s.lcp[r] - 1; }
+        
+        /**
+         * Automaton over byte classes: failure links are resolved into transitions,
+         * every step is one table lookup. Transition is (target * Classes) << 1 with the lowest bit
+         * set if target reports occurrences.
+         */
+        template <size_t States, size_t Classes>
+        struct table {
+            using entry_type = typename std::conditional<(States * Classes * 2 <= 0x10000), std::uint16_t, std::uint32_t>::type;
+            using class_type = typename std::conditional<(Classes <= 0x100), std::uint8_t, std::uint16_t>::type;
+            
+            class_type classes[256];
+            entry_type next[States * Classes];
+            std::uint32_t match[States];    // id of pattern ending at the state, ~0 if none
+            std::uint32_t output[States];   // the nearest state with match on the failure chain, 0 if none
+        };
+        
+        enum : std::uint32_t { no_match = ~std::uint32_t(0) };
+        
+    #if __cplusplus >= 201402L
+        template <typename P>
+        struct pattern_less {
+            constexpr bool operator()(size_t i, size_t j) const { return precedes<P>(i, j); } };
+        
+        /// Sorts patterns in O(N log N) comparisons
+        template <typename P>
+        constexpr shape<P::size> make_shape() {
+            constexpr size_t n = P::size;
+            shape<n> s{};
+            
+            for(size_t r = 0; r < n; ++r)
+                s.order[r] = r;
+            search_impl::heap_sort(s.order, n, pattern_less<P>());
+            
+            s.base[0] = 1;
+            for(size_t r = 0; r < n; ++r) {
+                char const* str = P::str[s.order[r]];
+                const size_t len = P::len[s.order[r]];
+                
+                s.lcp[r] = r == 0 ? 0 : common_prefix(P::str[s.order[r - 1]], str, ct::min(P::len[s.order[r - 1]], len));
+                s.base[r + 1] = s.base[r] + len - s.lcp[r];
+                for(size_t i = 0; i < len; ++i)
+                    s.bytes[byte(str[i]) / 64] |= std::uint64_t(1) << (byte(str[i]) % 64);
+            }
+            return s;
+        }
+        
+        template <typename P>
+        struct layout {
+            static constexpr shape<P::size> value = make_shape<P>();
+        };
+        
+        template <typename P>
+        constexpr shape<P::size> layout<P>::value;
+        
+        /// Builds trie in depth-first order, then resolves failure links in breadth-first order: O(States * Classes)
+        template <typename P, typename L, size_t States, size_t Classes>
+        constexpr table<States, Classes> build() {
+            using entry_type = typename table<States, Classes>::entry_type;
+            using class_type = typename table<States, Classes>::class_type;
+            
+            const shape<P::size> s = L::value;
+            table<States, Classes> t{};
+            size_t fail[States] = {}, queue[States] = {}, path[States] = {};
+            
+            for(size_t b = 0; b < 256; ++b)
+                t.classes[b] = class_type(class_of(s.bytes, b));
+            for(size_t v = 0; v < States; ++v)
+                t.match[v] = no_match;
+            
+            // Trie edges: path[l] is the node of prefix [0, l) of the current pattern, 0 is no edge
+            for(size_t r = 0; r < P::size; ++r) {
+                char const* str = P::str[s.order[r]];
+                const size_t len = P::len[s.order[r]];
+                for(size_t l = s.lcp[r]; l < len; ++l) {
+                    path[l + 1] = node_of(s, r, l + 1);
+                    t.next[path[l] * Classes + t.classes[byte(str[l])]] = entry_type(path[l + 1]);
+                }
+                if(len > s.lcp[r])
+                    t.match[path[len]] = std::uint32_t(s.order[r]);
+            }
+            
+            // Row of a state is resolved when it is dequeued: its non-zero entries are trie edges till then
+            size_t head = 0, tail = 0;
+            for(size_t k = 0; k < Classes; ++k)
+                if(t.next[k] != 0)
+                    queue[tail++] = t.next[k];
+            while(head < tail) {
+                const size_t v = queue[head++];
+                for(size_t k = 0; k < Classes; ++k) {
+                    const size_t u = t.next[v * Classes + k];
+                    const size_t fallback = t.next[fail[v] * Classes + k];
+                    if(u == 0) {
+                        t.next[v * Classes + k] = entry_type(fallback);
+                        continue;
+                    }
+                    fail[u] = fallback;
+                    t.output[u] = t.match[fallback] != no_match ? std::uint32_t(fallback) : t.output[fallback];
+                    queue[tail++] = u;
+                }
+            }
+            
+            for(size_t i = 0; i < States * Classes; ++i) {
+                const size_t u = t.next[i];
+                t.next[i] = entry_type((u * Classes) << 1 | (t.match[u] != no_match || t.output[u] != 0));
+            }
+            return t;
+        }
+    #else
+        template <typename P>
+        constexpr size_t count_preceding(size_t i, size_t lo, size_t hi) {
+            return hi - lo == 1 ? size_t(precedes<P>(lo, i)) : count_preceding<P>(i, lo, lo + (hi - lo)/2) + count_preceding<P>(i, lo + (hi - lo)/2, hi); }
+        
+        /// Index of value v in a[lo, hi), npos if none
+        constexpr size_t index_of(size_t const* a, size_t v, size_t lo, size_t hi) {
+            return hi - lo == 1 ? (a[lo] == v ? lo : size_t(npos)) : ct::min(index_of(a, v, lo, lo + (hi - lo)/2), index_of(a, v, lo + (hi - lo)/2, hi)); }
+        
+        /// Bit set word w of bytes s[lo, hi)
+        constexpr std::uint64_t byte_bits(char const* s, size_t w, size_t lo, size_t hi) {
+            return
+            (hi - lo <= 1) ? (
+                lo < hi && byte(s[lo]) / 64 == w ? std::uint64_t(1) << (byte(s[lo]) % 64) : 0
+            ) : (
+                byte_bits(s, w, lo, lo + (hi - lo)/2) | byte_bits(s, w, lo + (hi - lo)/2, hi)
+            );
+        }
+        
+        template <typename P>
+        constexpr std::uint64_t pattern_bits(size_t w, size_t lo, size_t hi) {
+            return hi - lo == 1 ? byte_bits(P::str[lo], w, 0, P::len[lo]) : pattern_bits<P>(w, lo, lo + (hi - lo)/2) | pattern_bits<P>(w, lo + (hi - lo)/2, hi); }
+        
+        /**
+         * Construction stage as one value: every stage is built by a single constant evaluation,
+         * gcc copies a static array on each read from a separate one
+         */
+        template <typename T, size_t N>
+        struct stage { T at[N]; };
+        
+        template <typename P, size_t... I>
+        constexpr stage<size_t, sizeof...(I)> ranks(index_sequence<I...>) {
+            return stage<size_t, sizeof...(I)>{ { count_preceding<P>(I, 0, P::size)... } }; }
+        
+        template <typename P, size_t N, size_t... I>
+        constexpr stage<size_t, N> lcps(size_t const* order, index_sequence<I...>) {
+            return stage<size_t, N>{ { (I == 0 ? 0 : common_prefix(P::str[order[I == 0 ? 0 : I - 1]], P::str[order[I]],
+                ct::min(P::len[order[I == 0 ? 0 : I - 1]], P::len[order[I]])))... } };
+        }
+        
+        /// Nodes added by the r-th pattern
+        template <typename P, size_t N, size_t... I>
+        constexpr stage<size_t, N> added(size_t const* order, stage<size_t, N> const& lcp, index_sequence<I...>) {
+            return stage<size_t, N>{ { (P::len[order[I]] - lcp.at[I])... } }; }
+        
+        template <typename P, size_t N, size_t... I>
+        constexpr shape<N> make_shape(size_t const* order, stage<size_t, N> const& lcp, stage<size_t, N> const& nodes, index_sequence<I...>) {
+            return shape<N>{
+                { order[I]... }, { lcp.at[I]... },
+                { 1 + perfect_hash_impl::sum(nodes.at, 0, I)..., 1 + perfect_hash_impl::sum(nodes.at, 0, N) },
+                { pattern_bits<P>(0, 0, N), pattern_bits<P>(1, 0, N), pattern_bits<P>(2, 0, N), pattern_bits<P>(3, 0, N) }
+            };
+        }
+        
+        /// Order is found element-wise: N searches in one evaluation exceed the operation limit
+        template <typename P, typename Indices = make_index_sequence_t<P::size>>
+        struct layout;
+        
+        template <typename P, size_t... I>
+        struct layout<P, index_sequence<I...>> {
+            using indices = index_sequence<I...>;
+            
+            static constexpr stage<size_t, P::size> rank = ranks<P>(indices{});
+            static constexpr size_t order[sizeof...(I)] = { index_of(rank.at, I, 0, P::size)... };
+            static constexpr stage<size_t, P::size> lcp = lcps<P, P::size>(order, indices{});
+            static constexpr shape<P::size> value = make_shape<P>(order, lcp, added<P>(order, lcp, indices{}), indices{});
+        };
+        
+        template <typename P, size_t... I>
+        constexpr stage<size_t, P::size> layout<P, index_sequence<I...>>::rank;
+        
+        template <typename P, size_t... I>
+        constexpr size_t layout<P, index_sequence<I...>>::order[];
+        
+        template <typename P, size_t... I>
+        constexpr stage<size_t, P::size> layout<P, index_sequence<I...>>::lcp;
+        
+        template <typename P, size_t... I>
+        constexpr shape<P::size> layout<P, index_sequence<I...>>::value;
+        
+        /// Rank of pattern which added node v > 0: the last r with base[r] <= v in [lo, hi)
+        template <size_t N>
+        constexpr size_t rank_of(shape<N> const& s, size_t v, size_t lo, size_t hi) {
+            return hi - lo == 1 ? lo : (s.base[lo + (hi - lo)/2] <= v ? rank_of(s, v, lo + (hi - lo)/2, hi) : rank_of(s, v, lo, lo + (hi - lo)/2)); }
+        
+        /// Pattern of rank x has prefix q[0, k)
+        template <typename P, size_t N>
+        constexpr bool has_prefix(shape<N> const& s, size_t x, char const* q, size_t k) {
+            return P::len[s.order[x]] >= k && common_prefix(P::str[s.order[x]], q, k) == k; }
+        
+        /// The first rank in [lo, hi) which pattern prefix [0, k) is not less than q[0, k)
+        template <typename P, size_t N>
+        constexpr size_t lower_bound(shape<N> const& s, char const* q, size_t k, size_t lo, size_t hi) {
+            return
+            (lo == hi) ? lo : (
+                compare_n(P::str[s.order[lo + (hi - lo)/2]], q, k) < 0 ?
+                    lower_bound<P>(s, q, k, lo + (hi - lo)/2 + 1, hi) :
+                    lower_bound<P>(s, q, k, lo, lo + (hi - lo)/2)
+            );
+        }
+        
+        /// Node of string q[0, k), 0 if it is not a prefix of patterns
+        template <typename P, size_t N>
+        constexpr size_t find_node(shape<N> const& s, char const* q, size_t k, size_t x) {
+            return x < N && has_prefix<P>(s, x, q, k) ? node_of(s, x, k) : 0; }
+        
+        template <typename P, size_t N>
+        constexpr size_t find_node(shape<N> const& s, char const* q, size_t k) {
+            return k == 0 ? 0 : find_node<P>(s, q, k, lower_bound<P>(s, q, k, 0, N)); }
+        
+        /// Failure link of node: the longest proper suffix q[l - k, l) being a node, k decreases
+        template <typename P, size_t N>
+        struct suffix_search {
+            shape<N> const* s;
+            char const* q;
+            size_t l, k, node;
+            
+            constexpr bool done() const { return node != 0 || k == 0; }
+            
+            constexpr suffix_search next() const {
+                return suffix_search{s, q, l, k - 1, find_node<P>(*s, q + l - (k - 1), k - 1)}; }
+        };
+        
+        /// Pattern of rank x prefixed by q[0, l) with byte c at l
+        template <typename P, size_t N>
+        constexpr bool edge_before(shape<N> const& s, size_t x, char const* q, size_t l, size_t c) {
+            return has_prefix<P>(s, x, q, l) && (P::len[s.order[x]] == l || byte(P::str[s.order[x]][l]) < c); }
+        
+        /// The first rank in [lo, hi) not before edge (q[0, l), c)
+        template <typename P, size_t N>
+        constexpr size_t edge_bound(shape<N> const& s, char const* q, size_t l, size_t c, size_t lo, size_t hi) {
+            return
+            (lo == hi) ? lo : (
+                edge_before<P>(s, lo + (hi - lo)/2, q, l, c) ?
+                    edge_bound<P>(s, q, l, c, lo + (hi - lo)/2 + 1, hi) :
+                    edge_bound<P>(s, q, l, c, lo, lo + (hi - lo)/2)
+            );
+        }
+        
+        /// Bit set word w of bytes following prefix [0, l) in patterns of rank x onwards, stops at the end of the subtree
+        template <typename P, size_t N>
+        struct edge_scan {
+            shape<N> const* s;
+            size_t l, w, x;
+            std::uint64_t bits;
+            
+            constexpr bool done() const { return x >= N || s->lcp[x] < l; }
+            
+            constexpr std::uint64_t bit(size_t r) const {
+                return P::len[s->order[r]] > l && byte(P::str[s->order[r]][l]) / 64 == w ? std::uint64_t(1) << (byte(P::str[s->order[r]][l]) % 64) : 0; }
+            
+            constexpr edge_scan next() const {
+                return edge_scan{s, l, w, x + 1, s->lcp[x] == l ? bits | bit(x) : bits}; }
+        };
+        
+        template <typename P, size_t N>
+        constexpr size_t child_at(shape<N> const& s, char const* q, size_t l, size_t c, size_t x) {
+            return x < N && has_prefix<P>(s, x, q, l) && P::len[s.order[x]] > l && byte(P::str[s.order[x]][l]) == c ? node_of(s, x, l + 1) : 0; }
+        
+        /// The nearest state with match on the failure chain starting from v
+        constexpr std::uint32_t output_from(std::uint32_t const* match, size_t const* fail, size_t v) {
+            return v == 0 || match[v] != no_match ? std::uint32_t(v) : output_from(match, fail, fail[v]); }
+        
+        /// Rank of pattern which added the node
+        template <size_t N, size_t... V>
+        constexpr stage<size_t, sizeof...(V)> node_ranks(shape<N> const& s, index_sequence<V...>) {
+            return stage<size_t, sizeof...(V)>{ { (V == 0 ? 0 : rank_of(s, V, 0, N))... } }; }
+        
+        template <size_t N, size_t States, size_t... V>
+        constexpr stage<size_t, States> node_depths(shape<N> const& s, stage<size_t, States> const& rank, index_sequence<V...>) {
+            return stage<size_t, States>{ { (V == 0 ? 0 : s.lcp[rank.at[V]] + 1 + V - s.base[rank.at[V]])... } }; }
+        
+        template <typename P, size_t N, size_t States, size_t... V>
+        constexpr stage<std::uint32_t, States> node_matches(shape<N> const& s, stage<size_t, States> const& rank, stage<size_t, States> const& depth, index_sequence<V...>) {
+            return stage<std::uint32_t, States>{ {
+                (V != 0 && depth.at[V] == P::len[s.order[rank.at[V]]] ? std::uint32_t(s.order[rank.at[V]]) : std::uint32_t(no_match))... } };
+        }
+        
+        template <typename P, size_t N, size_t States, size_t... V>
+        constexpr stage<size_t, States> node_fails(shape<N> const& s, stage<size_t, States> const& rank, stage<size_t, States> const& depth, index_sequence<V...>) {
+            return stage<size_t, States>{ {
+                (depth.at[V] <= 1 ? 0 : search_impl::run(suffix_search<P, N>{&s, P::str[s.order[rank.at[V]]], depth.at[V], depth.at[V], 0}).node)... } };
+        }
+        
+        template <size_t States, size_t... V>
+        constexpr stage<std::uint32_t, States> node_outputs(stage<std::uint32_t, States> const& match, stage<size_t, States> const& fail, index_sequence<V...>) {
+            return stage<std::uint32_t, States>{ { (V == 0 ? 0 : output_from(match.at, fail.at, fail.at[V]))... } }; }
+        
+        /// Bytes of trie edges of nodes as bit set word w, subtree of node v spans ranks [rank[v], ...)
+        template <typename P, size_t N, size_t States, size_t... V>
+        constexpr stage<std::uint64_t, States> node_edges(shape<N> const& s, stage<size_t, States> const& rank, stage<size_t, States> const& depth, size_t w, index_sequence<V...>) {
+            return stage<std::uint64_t, States>{ {
+                search_impl::run(edge_scan<P, N>{&s, depth.at[V], w, rank.at[V] + 1, edge_scan<P, N>{&s, depth.at[V], w, 0, 0}.bit(rank.at[V])}).bits... } };
+        }
+        
+        template <size_t... B>
+        constexpr stage<size_t, 256> byte_classes(std::uint64_t const* bytes, index_sequence<B...>) {
+            return stage<size_t, 256>{ { class_of(bytes, B)... } }; }
+        
+        /// Byte of class k > 0
+        template <size_t Classes, size_t... B>
+        constexpr stage<size_t, 256> class_bytes(stage<size_t, 256> const& classes, index_sequence<B...>) {
+            return stage<size_t, 256>{ { (B == 0 || B >= Classes ? 0 : index_of(classes.at, B, 0, 256))... } }; }
+        
+        /// Trie edge from node v by byte c, 0 if none: searched for existing edges only
+        template <typename P, size_t N, size_t States>
+        constexpr size_t child(shape<N> const& s, stage<size_t, States> const& rank, stage<size_t, States> const& depth,
+                               stage<std::uint64_t, States> const* edges, size_t v, size_t c) {
+            return ((edges[c / 64].at[v] >> (c % 64)) & 1) == 0 ? 0 : child_at<P>(s, P::str[s.order[rank.at[v]]], depth.at[v], c,
+                edge_bound<P>(s, P::str[s.order[rank.at[v]]], depth.at[v], c, rank.at[v], N));
+        }
+        
+        template <typename P, size_t N, size_t States, size_t Classes, size_t... B>
+        constexpr stage<size_t, 256> root_edges(shape<N> const& s, stage<size_t, States> const& rank, stage<size_t, States> const& depth,
+                                                stage<std::uint64_t, States> const* edges, stage<size_t, 256> const& bytes, index_sequence<B...>) {
+            return stage<size_t, 256>{ { (B == 0 || B >= Classes ? 0 : child<P>(s, rank, depth, edges, 0, bytes.at[B]))... } }; }
+        
+        /// Stages over nodes: rank of pattern which added the node, depth, match, failure links and bytes of trie edges
+        template <typename P, typename L, size_t States, size_t Classes>
+        struct nodes {
+            using indices = make_index_sequence_t<States>;
+            using bytes_indices = make_index_sequence_t<256>;
+            
+            static constexpr stage<size_t, States> rank = node_ranks(L::value, indices{});
+            static constexpr stage<size_t, States> depth = node_depths(L::value, rank, indices{});
+            static constexpr stage<std::uint32_t, States> match = node_matches<P>(L::value, rank, depth, indices{});
+            static constexpr stage<size_t, States> fail = node_fails<P>(L::value, rank, depth, indices{});
+            static constexpr stage<std::uint32_t, States> output = node_outputs(match, fail, indices{});
+            
+            static constexpr stage<std::uint64_t, States> edges[4] = {
+                node_edges<P>(L::value, rank, depth, 0, indices{}), node_edges<P>(L::value, rank, depth, 1, indices{}),
+                node_edges<P>(L::value, rank, depth, 2, indices{}), node_edges<P>(L::value, rank, depth, 3, indices{})
+            };
+            
+            static constexpr stage<size_t, 256> classes = byte_classes(L::value.bytes, bytes_indices{});
+            static constexpr stage<size_t, 256> bytes = class_bytes<Classes>(classes, bytes_indices{});
+            static constexpr stage<size_t, 256> root = root_edges<P, P::size, States, Classes>(L::value, rank, depth, edges, bytes, bytes_indices{});
+            
+            /// Transition from v by class k: edges of v or of its failure chain
+            static constexpr size_t delta(size_t v, size_t k) {
+                return v == 0 ? root.at[k] : delta(v, k, child<P>(L::value, rank, depth, edges, v, bytes.at[k])); }
+            
+            static constexpr size_t delta(size_t v, size_t k, size_t edge) {
+                return edge != 0 ? edge : delta(fail.at[v], k); }
+            
+            static constexpr size_t entry(size_t u) {
+                return (u * Classes) << 1 | (match.at[u] != no_match || output.at[u] != 0); }
+            
+            static constexpr size_t transition(size_t i) {
+                return i % Classes == 0 ? 0 : entry(delta(i / Classes, i % Classes)); }
+        };
+        
+        template <typename P, typename L, size_t States, size_t Classes>
+        constexpr stage<size_t, States> nodes<P, L, States, Classes>::rank;
+        
+        template <typename P, typename L, size_t States, size_t Classes>
+        constexpr stage<size_t, States> nodes<P, L, States, Classes>::depth;
+        
+        template <typename P, typename L, size_t States, size_t Classes>
+        constexpr stage<std::uint32_t, States> nodes<P, L, States, Classes>::match;
+        
+        template <typename P, typename L, size_t States, size_t Classes>
+        constexpr stage<size_t, States> nodes<P, L, States, Classes>::fail;
+        
+        template <typename P, typename L, size_t States, size_t Classes>
+        constexpr stage<std::uint32_t, States> nodes<P, L, States, Classes>::output;
+        
+        template <typename P, typename L, size_t States, size_t Classes>
+        constexpr stage<std::uint64_t, States> nodes<P, L, States, Classes>::edges[];
+        
+        template <typename P, typename L, size_t States, size_t Classes>
+        constexpr stage<size_t, 256> nodes<P, L, States, Classes>::classes;
+        
+        template <typename P, typename L, size_t States, size_t Classes>
+        constexpr stage<size_t, 256> nodes<P, L, States, Classes>::bytes;
+        
+        template <typename P, typename L, size_t States, size_t Classes>
+        constexpr stage<size_t, 256> nodes<P, L, States, Classes>::root;
+        
+        template <typename P, typename L, size_t States, size_t Classes, size_t... B, size_t... I, size_t... V>
+        constexpr table<States, Classes> build(index_sequence<B...>, index_sequence<I...>, index_sequence<V...>) {
+            using N = nodes<P, L, States, Classes>;
+            using T = table<States, Classes>;
+            return T{
+                { typename T::class_type(N::classes.at[B])... },
+                { typename T::entry_type(N::transition(I))... },
+                { N::match.at[V]... },
+                { N::output.at[V]... }
+            };
+        }
+        
+        /// Builds table with O(log N) recursion depth and O(States * Classes * log N) evaluations
+        template <typename P, typename L, size_t States, size_t Classes>
+        constexpr table<States, Classes> build() {
+            return build<P, L, States, Classes>(make_index_sequence_t<256>{}, make_index_sequence_t<States * Classes>{}, make_index_sequence_t<States>{}); }
+    #endif
+        
+        /// Patterns are distinct: equal ones are neighbours in lexicographical order
+        template <typename P, size_t N>
+        constexpr bool distinct(shape<N> const& s, size_t lo, size_t hi) {
+            return
+            (hi - lo == 1) ? (
+                lo == 0 || s.lcp[lo] != P::len[s.order[lo]] || P::len[s.order[lo - 1]] != P::len[s.order[lo]]
+            ) : (
+                distinct<P>(s, lo, lo + (hi - lo)/2) && distinct<P>(s, lo + (hi - lo)/2, hi)
+            );
+        }
+        
+        template <typename P>
+        constexpr bool non_empty(size_t lo, size_t hi) {
+            return hi - lo == 1 ? P::len[lo] != 0 : non_empty<P>(lo, lo + (hi - lo)/2) && non_empty<P>(lo + (hi - lo)/2, hi); }
+        
+    } // aho_corasick_impl
+
+    /**
+     * Aho-Corasick automaton of distinct non-empty patterns (tuple of strings) built at compile time.
+     * Trie edges and failure links are flattened into one static transition table over byte classes,
+     * scan() reports every (possibly overlapping, as find_all) occurrence in a single pass.
+     */
+    template <typename Patterns>
+    struct aho_corasick;
+
+    template <typename... S>
+    struct aho_corasick<std::tuple<S...>> {
+        static_assert(sizeof...(S) > 0, LOG_HEAD "empty pattern set");
+        static_assert(std::is_same<std::tuple<char, typename S::CharT...>, std::tuple<typename S::CharT..., char>>::value,
+            LOG_HEAD "aho_corasick supports char patterns only");
+        
+        using patterns = aho_corasick_impl::patterns<S...>;
+        using layout = aho_corasick_impl::layout<patterns>;
+        
+        static_assert(aho_corasick_impl::non_empty<patterns>(0, sizeof...(S)), LOG_HEAD "empty pattern");
+        static_assert(aho_corasick_impl::distinct<patterns>(layout::value, 0, sizeof...(S)), LOG_HEAD "duplicate patterns");
+        
+        enum : size_t {
+            size = sizeof...(S),
+            states = layout::value.base[sizeof...(S)],
+            classes = 1 + aho_corasick_impl::bytes_below(layout::value.bytes, 256)
+        };
+        
+        using table = aho_corasick_impl::table<states, classes>;
+        
+        /// Transitions, byte classes and matches, static constexpr: no initialization at runtime
+        static constexpr table value = aho_corasick_impl::build<patterns, layout, states, classes>();
+        
+        /**
+         * Calls callback(id, offset) for every occurrence in buf[0, n): ordered by end position,
+         * longer patterns first for the same end. @returns the number of occurrences
+         */
+        template <typename Callback>
+        static size_t scan(char const* buf, size_t n, Callback&& callback) {
+            size_t row = 0, count = 0;
+            for(size_t i = 0; i < n; ++i) {
+                const size_t entry = value.next[row + value.classes[static_cast<unsigned char>(buf[i])]];
+                row = entry >> 1;
+                if(entry & 1)
+                    count += report(row / classes, i + 1, callback);
+            }
+            return count;
+        }
+        
+        template <typename Callback>
+        static size_t scan(std::string const& buf, Callback&& callback) {
+            return scan(buf.data(), buf.size(), callback); }
+        
+    private:
+        template <typename Callback>
+        static size_t report(size_t state, size_t end, Callback& callback) {
+            size_t count = 0;
+            for(size_t v = value.match[state] != aho_corasick_impl::no_match ? state : value.output[state]; v != 0; v = value.output[v], ++count)
+                callback(size_t(value.match[v]), end - patterns::len[value.match[v]]);
+            return count;
+        }
+    };
+
+    template <typename... S>
+    constexpr typename aho_corasick<std::tuple<S...>>::table aho_corasick<std::tuple<S...>>::value;
+
+    /// --- Formatting --- ///
+
+    namespace format_impl {
+        
+        /// Character of S, '\0' past its end
+        template <typename S>
+        constexpr char char_at(size_t idx) {
+            return idx < size_t(S::length) ? static_cast<char>(S::at(idx)) : '\0'; }
+        
+        template <typename S>
+        constexpr size_t digits_end(size_t pos) {
+            return (char_at<S>(pos) >= '0' && char_at<S>(pos) <= '9') ? digits_end<S>(pos + 1) : pos; }
+        
+        template <typename S>
+        constexpr size_t number(size_t pos, size_t end, size_t acc = 0) {
+            return pos >= end ? acc : number<S>(pos + 1, end, acc * 10 + size_t(char_at<S>(pos) - '0')); }
+        
+        /// Length modifiers, indices of declared_types
+        enum modifier : int { mod_hh, mod_h, mod_none, mod_l, mod_ll, mod_z };
+        
+        using declared_types = std::tuple<signed char, short, int, long, long long, std::make_signed<size_t>::type>;
+        
+        template <typename S>
+        constexpr modifier modifier_at(size_t pos) {
+            return
+            char_at<S>(pos) == 'h' ? (char_at<S>(pos + 1) == 'h' ? mod_hh : mod_h) :
+            char_at<S>(pos) == 'l' ? (char_at<S>(pos + 1) == 'l' ? mod_ll : mod_l) :
+            char_at<S>(pos) == 'z' ? mod_z : mod_none;
+        }
+        
+        constexpr size_t modifier_length(modifier m) {
+            return (m == mod_hh || m == mod_ll) ? 2 : m == mod_none ? 0 : 1; }
+        
+        constexpr bool is_conversion(char c) {
+            return c == 'd' || c == 'i' || c == 'u' || c == 'x' || c == 'X' || c == 'c' || c == 's'; }
+        
+        template <typename T>
+        struct is_char : std::integral_constant<bool,
+            std::is_same<T, char>::value || std::is_same<T, signed char>::value || std::is_same<T, unsigned char>::value> {};
+        
+        template <typename T>
+        struct is_string : std::integral_constant<bool,
+            std::is_same<T, char const*>::value || std::is_same<T, char*>::value || std::is_same<T, std::string>::value> {};
+        
+        /// Two-digit groups of decimal numbers
+        template <typename = void>
+        struct digit_pairs {
+            static constexpr char value[201] =
+                "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+                "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+                "8081828384858687888990919293949596979899";
+        };
+        
+        template <typename T>
+        constexpr char digit_pairs<T>::value[201];
+        
+        template <typename U>
+        inline size_t decimal_length(U v) {
+            size_t n = 1;
+            for(;;) {
+                if(v < 10)    return n;
+                if(v < 100)   return n + 1;
+                if(v < 1000)  return n + 2;
+                if(v < 10000) return n + 3;
+                v /= 10000;
+                n += 4;
+            }
+        }
+        
+        /// Writes n decimal digits of v to out[0, n), two at a time from the end
+        template <typename U>
+        inline void put_decimal(char* out, U v, size_t n) {
+            char* p = out + n;
+            while(v >= 100) {
+                const size_t pair = size_t(v % 100) * 2;
+                v /= 100;
+                p -= 2;
+                std::memcpy(p, digit_pairs<>::value + pair, 2);
+            }
+            if(v >= 10)
+                std::memcpy(p - 2, digit_pairs<>::value + size_t(v) * 2, 2);
+            else
+                p[-1] = char('0' + v);
+        }
+        
+        template <typename U>
+        inline size_t hex_length(U v) {
+            size_t n = 1;
+            for(v >>= 4; v != 0; v >>= 4)
+                ++n;
+            return n;
+        }
+        
+        /// Spaces before a field of n characters right-justified in Width
+        template <size_t Width>
+        inline char* pad(char* out, size_t n) {
+            const size_t fill = Width > n ? Width - n : 0;
+            std::memset(out, ' ', fill);
+            return out + fill;
+        }
+        
+        /// Sign and magnitude right-justified in Width, zeros go after the sign if Zero
+        template <bool Zero, size_t Width, typename U>
+        inline char* put_number(char* out, U magnitude, bool negative) {
+            const size_t n = decimal_length(magnitude);
+            if(!Zero)
+                out = pad<Width>(out, n + negative);
+            *out = '-'; // overwritten by digits if not negative
+            out += negative;
+            if(Zero) {
+                const size_t fill = Width > n + negative ? Width - n - negative : 0;
+                std::memset(out, '0', fill);
+                out += fill;
+            }
+            put_decimal(out, magnitude, n);
+            return out + n;
+        }
+        
+        template <bool Zero, size_t Width, bool Upper, typename U>
+        inline char* put_hex(char* out, U v) {
+            const size_t n = hex_length(v);
+            const size_t fill = Width > n ? Width - n : 0;
+            std::memset(out, Zero ? '0' : ' ', fill);
+            out += fill;
+            char const* hex = Upper ? "0123456789ABCDEF" : "0123456789abcdef";
+            for(char* p = out + n; p != out; v >>= 4)
+                *--p = hex[v & 15];
+            return out + n;
+        }
+        
+        template <int K>
+        using kind = std::integral_constant<int, K>;
+        
+        /// Typed placeholder: accepted argument types, worst-case size and writer
+        template <char Conversion, int Mod, bool Zero, size_t Width, size_t Precision>
+        struct placeholder {
+            using signed_type = typename std::tuple_element<Mod, declared_types>::type;
+            using unsigned_type = typename std::make_unsigned<signed_type>::type;
+            
+            /// Values are converted to the declared type and written in promoted ones, as printf does
+            using signed_work = typename std::common_type<signed_type, int>::type;
+            using unsigned_work = typename std::make_unsigned<signed_work>::type;
+            
+            enum : bool { is_signed = Conversion == 'd' || Conversion == 'i' };
+            enum : bool { is_hex = Conversion == 'x' || Conversion == 'X' };
+            
+            enum : size_t { body =
+                Conversion == 'c' ? 1 :
+                Conversion == 's' ? Precision :
+                is_hex ? 2 * sizeof(unsigned_type) :
+                is_signed ? 1 + value_text_impl::digits(static_cast<unsigned_type>(~unsigned_type(0)) / 2 + 1) :
+                value_text_impl::digits(static_cast<unsigned_type>(~unsigned_type(0)))
+            };
+            
+            enum : size_t { max_size = Width > size_t(body) ? Width : size_t(body) };
+            
+            /**
+             * Integers of conversion's signedness not wider than the declared type (signed conversions
+             * also take narrower unsigned ones), characters for %c, char pointers and std::string for %s
+             */
+            template <typename A, typename T = typename std::decay<A>::type>
+            struct accepts : std::integral_constant<bool,
+                Conversion == 'c' ? is_char<T>::value :
+                Conversion == 's' ? is_string<T>::value :
+                std::is_integral<T>::value && !std::is_same<T, bool>::value && (is_signed ?
+                    (std::is_signed<T>::value ? sizeof(T) <= sizeof(signed_type) : sizeof(T) < sizeof(signed_type)) :
+                    (std::is_unsigned<T>::value && sizeof(T) <= sizeof(unsigned_type)))> {};
+            
+            /// Writes at most max_size characters of arg, @returns the end of output
+            template <typename A>
+            static char* write(char* out, A const& arg) {
+                static_assert(accepts<A>::value, LOG_HEAD "argument type does not match placeholder");
+                return put(out, arg, kind<Conversion == 'c' ? 0 : Conversion == 's' ? 1 : is_signed ? 2 : is_hex ? 4 : 3>{});
+            }
+            
+        private:
+            template <typename A>
+            static char* put(char* out, A c, kind<0>) {
+                out = pad<Width>(out, 1);
+                *out = static_cast<char>(c);
+                return out + 1;
+            }
+            
+            static char* put(char* out, char const* s, kind<1>) {
+                void const* null = std::memchr(s, '\0', Precision);
+                return copy(out, s, null != nullptr ? size_t(static_cast<char const*>(null) - s) : size_t(Precision));
+            }
+            
+            static char* put(char* out, std::string const& s, kind<1>) {
+                return copy(out, s.data(), ct::min(s.size(), size_t(Precision))); }
+            
+            template <typename A>
+            static char* put(char* out, A v, kind<2>) {
+                const signed_work value = static_cast<signed_type>(v);
+                const bool negative = value < 0;
+                return put_number<Zero, Width>(out, negative ? unsigned_work(0) - unsigned_work(value) : unsigned_work(value), negative);
+            }
+            
+            template <typename A>
+            static char* put(char* out, A v, kind<3>) {
+                return put_number<Zero, Width>(out, unsigned_work(static_cast<unsigned_type>(v)), false); }
+            
+            template <typename A>
+            static char* put(char* out, A v, kind<4>) {
+                return put_hex<Zero, Width, Conversion == 'X'>(out, unsigned_work(static_cast<unsigned_type>(v))); }
+            
+            static char* copy(char* out, char const* s, size_t n) {
+                out = pad<Width>(out, n);
+                std::memcpy(out, s, n);
+                return out + n;
+            }
+        };
+        
+        /// Placeholder "%[0][width][.precision][hh|h|l|ll|z]conversion" of S, Pos is the position after '%'
+        template <typename S, size_t Pos>
+        struct spec {
+            enum : bool { zero = char_at<S>(Pos) == '0' };
+            enum : size_t { width_end = digits_end<S>(Pos + zero) };
+            enum : bool { bounded = char_at<S>(width_end) == '.' };
+            enum : size_t { precision_end = bounded ? digits_end<S>(width_end + 1) : size_t(width_end) };
+            enum : int { mod = modifier_at<S>(precision_end) };
+            enum : size_t { conversion_pos = precision_end + modifier_length(modifier(mod)) };
+            enum : char { conversion = char_at<S>(conversion_pos) };
+            enum : size_t { end = conversion_pos + 1 };
+            
+            static_assert(is_conversion(conversion), LOG_HEAD "unsupported conversion, expected one of d, i, u, x, X, c, s or %%");
+            static_assert(conversion != 's' || bounded, LOG_HEAD "%s must be bounded by precision, e.g. %.16s");
+            static_assert(conversion == 's' || !bounded, LOG_HEAD "precision is supported for %s only");
+            static_assert((conversion != 's' && conversion != 'c') || (!zero && mod == int(mod_none)),
+                LOG_HEAD "%c and %s take neither '0' flag nor length modifier");
+            
+            using type = placeholder<conversion, mod, zero, number<S>(Pos + zero, width_end),
+                number<S>(width_end + 1, precision_end)>;
+        };
+        
+        /// Literal characters [A, O) of S, copied with fixed-size memcpy
+        template <typename S, size_t A, size_t O>
+        struct chunk {
+            enum : size_t { max_size = O - A };
+            
+            static char* write(char* out) {
+                std::memcpy(out, S::str() + A, O - A);
+                return out + (O - A);
+            }
+        };
+        
+        template <typename S, size_t A, size_t O>
+        using chunks = typename std::conditional<(A < O), std::tuple<chunk<S, A, O>>, std::tuple<>>::type;
+        
+        /// Elements of S from Pos: literal chunks and placeholders, "%%" ends chunk with '%'
+        template <typename S, size_t Pos, size_t Next = find_substr(S::str(), "%", Pos),
+            bool Escape = Next != size_t(npos) && char_at<S>(Next + 1) == '%'>
+        struct parse {
+            using current = spec<S, Next + 1>;
+            using rest = parse<S, current::end>;
+            using type = tuple_concat_t<chunks<S, Pos, Next>, std::tuple<typename current::type>, typename rest::type>;
+            using placeholders = tuple_concat_t<std::tuple<typename current::type>, typename rest::placeholders>;
+            
+            enum : size_t { max_size = Next - Pos + current::type::max_size + rest::max_size };
+        };
+        
+        template <typename S, size_t Pos, size_t Next>
+        struct parse<S, Pos, Next, true> {
+            using rest = parse<S, Next + 2>;
+            using type = tuple_concat_t<chunks<S, Pos, Next + 1>, typename rest::type>;
+            using placeholders = typename rest::placeholders;
+            
+            enum : size_t { max_size = Next + 1 - Pos + rest::max_size };
+        };
+        
+        template <typename S, size_t Pos>
+        struct parse<S, Pos, size_t(npos), false> {
+            using type = chunks<S, Pos, S::length>;
+            using placeholders = std::tuple<>;
+            
+            enum : size_t { max_size = Pos < size_t(S::length) ? S::length - Pos : 0 };
+        };
+        
+        /// Writes elements in order, each placeholder takes the next argument
+        template <typename Elements>
+        struct writer;
+        
+        template <>
+        struct writer<std::tuple<>> {
+            static char* write(char* out) { return out; }
+        };
+        
+        template <typename S, size_t A, size_t O, typename... E>
+        struct writer<std::tuple<chunk<S, A, O>, E...>> {
+            template <typename... Args>
+            static char* write(char* out, Args const&... args) {
+                return writer<std::tuple<E...>>::write(chunk<S, A, O>::write(out), args...); }
+        };
+        
+        template <char C, int M, bool Z, size_t W, size_t P, typename... E>
+        struct writer<std::tuple<placeholder<C, M, Z, W, P>, E...>> {
+            template <typename Arg, typename... Args>
+            static char* write(char* out, Arg const& arg, Args const&... args) {
+                return writer<std::tuple<E...>>::write(placeholder<C, M, Z, W, P>::write(out, arg), args...); }
+        };
+        
+        template <typename Placeholders, typename Args, bool = std::tuple_size<Placeholders>::value == std::tuple_size<Args>::value>
+        struct accepts_all : std::false_type {};
+        
+        template <typename... P, typename... A>
+        struct accepts_all<std::tuple<P...>, std::tuple<A...>, true> : all_true<P::template accepts<A>::value...> {};
+        
+    } // format_impl
+
+    /**
+     * printf-like format S (ctstr::string) compiled at compile time into literal chunks and typed placeholders
+     * "%[0][width][.precision][hh|h|l|ll|z]conversion": d, i, u, x, X, c and s (bounded by precision), "%%" is '%'.
+     * Argument types are checked against placeholders, write() does neither parsing nor allocation:
+     *      using line = format<string<line_literal>>; // "id=%u sym=%.8s"
+     *      char buf[line::max_size];
+     *      const size_t n = line::write(buf, 42u, "AAPL");
+     */
+    template <typename S>
+    struct format {
+        static_assert(std::is_same<typename S::CharT, char>::value, LOG_HEAD "format supports char literals only");
+        
+        using parsed = format_impl::parse<S, 0>;
+        
+        /// Literal chunks and placeholders in order
+        using elements = typename parsed::type;
+        using placeholders = typename parsed::placeholders;
+        
+        enum : size_t {
+            arity = std::tuple_size<placeholders>::value,
+            max_size = parsed::max_size ///< worst-case output length, no null-terminator is written
+        };
+        
+        /// true if arguments of types A... match placeholders
+        template <typename... A>
+        using accepts = format_impl::accepts_all<placeholders, std::tuple<A...>>;
+        
+        /// Writes formatted args to out[0, max_size), @returns the number of characters written
+        template <typename... A>
+        static size_t write(char* out, A const&... args) {
+            static_assert(sizeof...(A) == size_t(arity), LOG_HEAD "number of arguments does not match placeholders");
+            return size_t(format_impl::writer<elements>::write(out, args...) - out);
+        }
+    };
+
+    /// --- Scanning --- ///
+
+    /// Characters [data, data + size) of scanned text, not owned
+    struct token {
+        char const* data;
+        size_t size;
+        
+        std::string to_string() const { return std::string(data, size); }
+    };
+
+    namespace scanner_impl {
+        
+        using format_impl::char_at;
+        using format_impl::kind;
+        
+        using word_type = std::uint64_t;
+        
+        enum : word_type { ascii_zeros = 0x3030303030303030ULL, high_bits = 0x8080808080808080ULL };
+        
+        /// Powers of 10 up to a word of digits
+        template <typename = void>
+        struct powers_of_10 {
+            static constexpr word_type value[9] = {1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000};
+        };
+        
+        template <typename T>
+        constexpr word_type powers_of_10<T>::value[9];
+        
+        /// Bytes [p, min(p + 8, end)) as little-endian word, zeros past end
+        inline word_type load_word(char const* p, char const* end) {
+            unsigned char bytes[8] = {};
+            if(end - p >= 8)
+                std::memcpy(bytes, p, 8);
+            else
+                std::memcpy(bytes, p, size_t(end - p));
+        #if (defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__) || defined(_MSC_VER)
+            word_type word;
+            std::memcpy(&word, bytes, 8);
+            return word;
+        #else
+            word_type word = 0;
+            for(size_t i = 8; i-- > 0;)
+                word = (word << 8) | bytes[i];
+            return word;
+        #endif
+        }
+        
+        /// Index of the first byte with high bit set in mask, 8 if none
+        inline size_t first_byte(word_type mask) {
+            if(mask == 0)
+                return 8;
+            const unsigned low = unsigned(mask);
+            return (low != 0 ? runtime_search_impl::lowest_bit(low) : 32 + runtime_search_impl::lowest_bit(unsigned(mask >> 32))) >> 3;
+        }
+        
+        /// Number of leading decimal digits in word: bytes below '0' and above '9' set their high bits
+        inline size_t digit_prefix(word_type word) {
+            const word_type d = word - word_type(ascii_zeros);
+            return first_byte((d | (d + 0x7676767676767676ULL)) & word_type(high_bits));
+        }
+        
+        enum : word_type { low_bits = 0x7F7F7F7F7F7F7F7FULL, ones = 0x0101010101010101ULL };
+        
+        /// High bits of bytes equal to c, exact: no carries cross bytes
+        inline word_type equal_bytes(word_type word, unsigned char c) {
+            const word_type x = word ^ (word_type(ones) * c);
+            return ~(((x & word_type(low_bits)) + word_type(low_bits)) | x) & word_type(high_bits);
+        }
+        
+        /// High bits of bytes in [lo, hi), hi <= 128
+        inline word_type bytes_in(word_type word, unsigned lo, unsigned hi) {
+            const word_type low = word & word_type(low_bits);
+            const word_type at_least_lo = (low + word_type(ones) * (128 - lo)) | word;
+            const word_type below_hi = ~((low + word_type(ones) * (128 - hi)) | word);
+            return at_least_lo & below_hi & word_type(high_bits);
+        }
+        
+        /// Number of leading bytes in word other than whitespace and Stop
+        template <char Stop>
+        inline size_t token_prefix(word_type word) {
+            return first_byte(equal_bytes(word, ' ') | bytes_in(word, '\t', '\r' + 1) |
+                equal_bytes(word, static_cast<unsigned char>(Stop)));
+        }
+        
+        /// Value of n <= 8 leading digits of word: digits are shifted to the top, then combined pairwise
+        inline word_type digits_value(word_type word, size_t n) {
+            word_type d = ((word - word_type(ascii_zeros)) << (4 * (8 - n))) << (4 * (8 - n));
+            d = d * 10 + (d >> 8);
+            return (((d & 0x000000FF000000FFULL) * (100 + (1000000ULL << 32))) +
+                    (((d >> 16) & 0x000000FF000000FFULL) * (1 + (10000ULL << 32)))) >> 32;
+        }
+        
+        /**
+         * Decimal of at most limit digits, 8 digits per step. Leading zeros are skipped before
+         * the digit count of U applies, so zero-padded fields are read.
+         * @returns the end of digits, nullptr if none or out of U
+         */
+        template <typename U>
+        inline char const* read_decimal(char const* p, char const* end, size_t limit, U& out) {
+            enum : size_t { max_digits = value_text_impl::digits(static_cast<U>(~U(0))) };
+            
+            size_t zeros = 0;
+            while(zeros < limit && p + zeros != end && p[zeros] == '0')
+                ++zeros;
+            p += zeros;
+            limit = ct::min(limit - zeros, size_t(max_digits) + 1); // one more digit rejects longer numbers
+            word_type value = 0;
+            size_t count = 0, n = 0;
+            do {
+                const word_type word = load_word(p + count, end);
+                n = ct::min(digit_prefix(word), limit - count);
+                const word_type low = digits_value(word, n);
+                if(count + n >= 20 && value > (~word_type(0) - low) / powers_of_10<>::value[n])
+                    return nullptr;
+                value = value * powers_of_10<>::value[n] + low;
+                count += n;
+            } while(n == 8 && count < limit);
+            
+            if(count + zeros == 0 || count > size_t(max_digits) || value > static_cast<U>(~U(0)))
+                return nullptr;
+            out = static_cast<U>(value);
+            return p + count;
+        }
+        
+        /// Optional sign and decimal magnitude in limit characters
+        template <typename T>
+        inline char const* read_signed(char const* p, char const* end, size_t limit, T& out) {
+            using U = typename std::make_unsigned<T>::type;
+            
+            const bool negative = p != end && *p == '-';
+            const bool sign = negative || (p != end && *p == '+');
+            U magnitude = 0;
+            char const* q = limit > size_t(sign) ? read_decimal(p + sign, end, limit - sign, magnitude) : nullptr;
+            if(q == nullptr || magnitude > U(static_cast<U>(~U(0)) / 2 + negative))
+                return nullptr;
+            out = negative ? T(-T(magnitude - 1) - 1) : T(magnitude);
+            return q;
+        }
+        
+        template <typename U>
+        inline char const* read_hex(char const* p, char const* end, size_t limit, U& out) {
+            word_type value = 0;
+            size_t count = 0;
+            for(; p + count != end && count < limit; ++count) {
+                const unsigned c = static_cast<unsigned char>(p[count]);
+                const unsigned digit = c - '0' < 10 ? c - '0' : (c | 0x20) - 'a' < 6 ? (c | 0x20) - 'a' + 10 : 16;
+                if(digit == 16)
+                    break;
+                if((value >> (8 * sizeof(U) - 4)) != 0)
+                    return nullptr;
+                value = (value << 4) | digit;
+            }
+            if(count == 0)
+                return nullptr;
+            out = static_cast<U>(value);
+            return p + count;
+        }
+        
+        /// Literal characters [A, O) of S, compared unrolled into words
+        template <typename S, size_t A, size_t O>
+        struct literal {
+            using text = typename S::template substr_t<A, O>;
+            
+            enum : size_t { length = O - A, unrolled_limit = 64 };
+            
+            static bool match(char const* p, char const* end) {
+                return size_t(end - p) >= size_t(length) &&
+                    runtime_search_impl::unrolled_equal<text, 0, ct::min(size_t(length), size_t(unrolled_limit))>::apply(p) && (
+                    size_t(length) <= size_t(unrolled_limit) ||
+                    std::memcmp(p + unrolled_limit, text::str() + unrolled_limit, length - unrolled_limit) == 0);
+            }
+        };
+        
+        /// Typed field: value type and decoder. Width limits characters (exact count for %c), Stop ends %s
+        template <char Conversion, int Mod, size_t Width, char Stop>
+        struct field {
+            using signed_type = typename std::tuple_element<Mod, format_impl::declared_types>::type;
+            using unsigned_type = typename std::make_unsigned<signed_type>::type;
+            
+            enum : bool { is_signed = Conversion == 'd' };
+            enum : size_t { limit = Width == 0 ? ~size_t(0) : Width };
+            
+            using value_type =
+                typename std::conditional<Conversion == 'c' && Width <= 1, char,
+                typename std::conditional<Conversion == 'c' || Conversion == 's', token,
+                typename std::conditional<is_signed, signed_type, unsigned_type>::type>::type>::type;
+            
+            /// @returns the end of field at p, nullptr if text does not match
+            static char const* read(char const* p, char const* end, value_type& out) {
+                return read(p, end, out, kind<Conversion == 'c' ? (Width <= 1 ? 0 : 1) : Conversion == 's' ? 2 :
+                    is_signed ? 3 : Conversion == 'x' ? 5 : 4>{});
+            }
+            
+        private:
+            static char const* read(char const* p, char const* end, char& out, kind<0>) {
+                if(p == end)
+                    return nullptr;
+                out = *p;
+                return p + 1;
+            }
+            
+            static char const* read(char const* p, char const* end, token& out, kind<1>) {
+                if(size_t(end - p) < Width)
+                    return nullptr;
+                out = token{p, Width};
+                return p + Width;
+            }
+            
+            static char const* read(char const* p, char const* end, token& out, kind<2>) {
+                const size_t available = ct::min(size_t(end - p), size_t(limit));
+                size_t n = 0, step = 0;
+                do {
+                    step = token_prefix<Stop>(load_word(p + n, end));
+                    n += step;
+                } while(step == 8 && n < available);
+                n = ct::min(n, available);
+                out = token{p, n};
+                return n != 0 ? p + n : nullptr;
+            }
+            
+            template <typename T>
+            static char const* read(char const* p, char const* end, T& out, kind<3>) {
+                return read_signed(p, end, limit, out); }
+            
+            template <typename T>
+            static char const* read(char const* p, char const* end, T& out, kind<4>) {
+                return read_decimal(p, end, limit, out); }
+            
+            template <typename T>
+            static char const* read(char const* p, char const* end, T& out, kind<5>) {
+                return read_hex(p, end, limit, out); }
+        };
+        
+        /// %i is not supported: scanf detects its base from "0x" and "0" prefixes
+        constexpr bool is_conversion(char c) {
+            return c == 'd' || c == 'u' || c == 'x' || c == 'c' || c == 's'; }
+        
+        /// Field "%[width][hh|h|l|ll|z]conversion" of S, Pos is the position after '%'
+        template <typename S, size_t Pos>
+        struct spec {
+            enum : size_t { width_end = format_impl::digits_end<S>(Pos) };
+            enum : int { mod = format_impl::modifier_at<S>(width_end) };
+            enum : size_t { conversion_pos = width_end + format_impl::modifier_length(format_impl::modifier(mod)) };
+            enum : char { conversion = char_at<S>(conversion_pos) };
+            enum : size_t { end = conversion_pos + 1 };
+            
+            /// Literal character following the field, if any
+            enum : char { stop = (char_at<S>(end) == '%' && char_at<S>(end + 1) != '%') ? '\0' : char_at<S>(end) };
+            
+            static_assert(is_conversion(conversion), LOG_HEAD "unsupported conversion, expected one of d, u, x, c, s or %%");
+            static_assert((conversion != 's' && conversion != 'c') || mod == int(format_impl::mod_none),
+                LOG_HEAD "%c and %s take no length modifier");
+            
+            using type = field<conversion, mod, format_impl::number<S>(Pos, width_end), stop>;
+        };
+        
+        template <typename S, size_t A, size_t O>
+        using literals = typename std::conditional<(A < O), std::tuple<literal<S, A, O>>, std::tuple<>>::type;
+        
+        /// Elements of S from Pos: literals and fields, "%%" ends literal with '%'
+        template <typename S, size_t Pos, size_t Next = find_substr(S::str(), "%", Pos),
+            bool Escape = Next != size_t(npos) && char_at<S>(Next + 1) == '%'>
+        struct parse {
+            using current = spec<S, Next + 1>;
+            using rest = parse<S, current::end>;
+            using type = tuple_concat_t<literals<S, Pos, Next>, std::tuple<typename current::type>, typename rest::type>;
+            using values = tuple_concat_t<std::tuple<typename current::type::value_type>, typename rest::values>;
+        };
+        
+        template <typename S, size_t Pos, size_t Next>
+        struct parse<S, Pos, Next, true> {
+            using rest = parse<S, Next + 2>;
+            using type = tuple_concat_t<literals<S, Pos, Next + 1>, typename rest::type>;
+            using values = typename rest::values;
+        };
+        
+        template <typename S, size_t Pos>
+        struct parse<S, Pos, size_t(npos), false> {
+            using type = literals<S, Pos, S::length>;
+            using values = std::tuple<>;
+        };
+        
+        /// Matches elements in order, I is the index of the next field value
+        template <typename Elements, size_t I = 0>
+        struct matcher;
+        
+        template <size_t I>
+        struct matcher<std::tuple<>, I> {
+            template <typename Values>
+            static char const* match(char const* p, char const*, Values&) { return p; }
+        };
+        
+        template <typename S, size_t A, size_t O, typename... E, size_t I>
+        struct matcher<std::tuple<literal<S, A, O>, E...>, I> {
+            template <typename Values>
+            static char const* match(char const* p, char const* end, Values& values) {
+                return literal<S, A, O>::match(p, end) ? matcher<std::tuple<E...>, I>::match(p + (O - A), end, values) : nullptr; }
+        };
+        
+        template <char C, int M, size_t W, char T, typename... E, size_t I>
+        struct matcher<std::tuple<field<C, M, W, T>, E...>, I> {
+            template <typename Values>
+            static char const* match(char const* p, char const* end, Values& values) {
+                p = field<C, M, W, T>::read(p, end, std::get<I>(values));
+                return p != nullptr ? matcher<std::tuple<E...>, I + 1>::match(p, end, values) : nullptr;
+            }
+        };
+        
+    } // scanner_impl
+
+    /**
+     * scanf-like pattern S (ctstr::string) compiled at compile time into literal delimiters and typed fields
+     * "%[width][hh|h|l|ll|z]conversion": d, u, x, c (%Nc takes exactly N characters) and s, "%%" is '%'.
+     * Unlike scanf, literal characters (spaces too) match exactly, %s also stops at the pattern character following it,
+     * %x takes hex digits only (no "0x" prefix) and %i (base from prefix) is not supported.
+     * Values are decoded into std::tuple without allocation, %s and %Nc are tokens pointing into the text:
+     *      using record = scanner<string<record_literal>>; // "id=%u ts=%llu sym=%s"
+     *      record::values v;
+     *      if(record::scan(line, n, v) != npos) use(std::get<0>(v), std::get<1>(v), std::get<2>(v).to_string());
+     */
+    template <typename S>
+    struct scanner {
+        static_assert(std::is_same<typename S::CharT, char>::value, LOG_HEAD "scanner supports char literals only");
+        
+        using parsed = scanner_impl::parse<S, 0>;
+        
+        /// Literals and fields in order
+        using elements = typename parsed::type;
+        using values = typename parsed::values;
+        
+        enum : size_t { arity = std::tuple_size<values>::value };
+        
+        /// Matches the pattern at the beginning of text[0, n), @returns the number of characters consumed, npos on mismatch
+        static size_t scan(char const* text, size_t n, values& out) {
+            char const* end = scanner_impl::matcher<elements>::match(text, text + n, out);
+            return end != nullptr ? size_t(end - text) : size_t(npos);
+        }
+        
+        static size_t scan(std::string const& text, values& out) {
+            return scan(text.data(), text.size(), out); }
+    };
+    
+    
+
+} // ctstr
+
+/// Experimental: compile time regex-to-DFA
+namespace cregex {
+    
+    namespace ctree {
+        template <typename L, typename T, typename R>
+        struct bintree {
+            using node  = T;
+            using left  = L;
+            using right = R;
+        };
+        
+        template <typename T>
+        using leaf = bintree<void, T, void>;
+        
+        template <typename Tree>
+        struct height;
+        
+        template <typename T>
+        struct height<leaf<T>> : std::integral_constant<size_t, 1> {};
+        
+        template <typename L, typename T, typename R>
+        struct height<bintree<L,T,R>> : std::integral_constant<size_t,
+            1 + max(height<L>::value, height<R>::value)
+        > {};
+    }
+    
+    using namespace ctstr;
+    
+    /// Nodes opearations
+    enum OPS : int {
+        CONC,   // Concat symbol    (.)
+        UNION,  // Union symbol     (|)
+        ITER    // Iteration symbol (*)
+    };
+    
+    struct OP_CONC : std::integral_constant<int, OPS::CONC>  {};
+    struct OP_UNIN : std::integral_constant<int, OPS::UNION> {};
+    struct OP_ITER : std::integral_constant<int, OPS::ITER>  {};
+    
+    /// Null-terminator (symbol '#')
+    enum : char { TERM = '\0' };
+    
+    template <typename LW, size_t P, char C>
+    struct position {
+        using literal = LW;
+        enum : size_t { pos = P };
+        enum : char { symbol = C };
+    };
+    
+    /// Alias (L,R ~ syntax_tree, T ~ operation)
+    template <typename L, typename T, typename R>
+    using syntax_tree = ctree::bintree<L, T, R>;
+    
+    /// Leaves contain positions (T ~ position)
+    template <typename T>
+    using syntax_leaf = syntax_tree<void, T, void>;
+    
+    template <typename L, typename>
+    struct tree_hang_left;
+    
+    template <typename L, typename T, typename R>
+    struct tree_hang_left<L, syntax_tree<void, T, R>> {
+        using type = syntax_tree<L, T, R>; };
+    
+    /// ---- nullable --- ///
+
+    template <typename>
+    struct nullable;
+    
+    template <typename T, size_t P>
+    struct nullable<syntax_leaf<position<T,P,TERM>>> : std::true_type {};
+    
+    template <typename T, size_t P, char C>
+    struct nullable<syntax_leaf<position<T,P,C>>> : std::false_type {};
+    
+    template <typename L, typename R>
+    struct nullable<syntax_tree<L,OP_UNIN,R>> : std::integral_constant<bool,
+        nullable<L>::value || nullable<R>::value
+    > {};
+    
+    template <typename L, typename R>
+    struct nullable<syntax_tree<L,OP_CONC,R>> : std::integral_constant<bool,
+        nullable<L>::value && nullable<R>::value
+    > {};
+    
+    template <typename L>
+    struct nullable<syntax_tree<L,OP_ITER,void>> : std::true_type {};
+    
+    /// ---- firstpos --- ///
+    
+    template <typename>
+    struct firstpos;
     
     template <typename T>
     struct firstpos<syntax_leaf<T>> {
@@ -364,11 +2911,11 @@ namespace cregex {
     
     template <typename L, typename R>
     struct firstpos<syntax_tree<L,OP_CONC,R>> {
-        using type = typename std::conditional<
+        using type = eval_if_t<
             nullable<L>::value,
-            typename firstpos<syntax_tree<L,OP_UNIN,R>>::type,
-            typename firstpos<L>::type
-        >::type;
+            firstpos<syntax_tree<L,OP_UNIN,R>>,
+            firstpos<L>
+        >;
     };
     
     template <typename L>
@@ -394,11 +2941,11 @@ namespace cregex {
     
     template <typename L, typename R>
     struct lastpos<syntax_tree<L,OP_CONC,R>> {
-        using type = typename std::conditional<
+        using type = eval_if_t<
             nullable<R>::value,
-            typename lastpos<syntax_tree<L,OP_UNIN,R>>::type,
-            typename lastpos<R>::type
-        >::type;
+            lastpos<syntax_tree<L,OP_UNIN,R>>,
+            lastpos<R>
+        >;
     };
     
     template <typename L>
@@ -429,4 +2976,7 @@ namespace cregex {
 } // ct
 } // ax
 
+#undef AX_CT_CTSTR_AVX2
+#undef AX_CT_CTSTR_SSE2
+#undef AX_CT_CTSTR_SSE42
 #undef LOG_HEAD
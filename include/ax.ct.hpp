@@ -3,6 +3,7 @@
 #include <algorithm>
 #include <string>
 #include <sstream>
+#include <tuple>
 #include <type_traits>
 #include <utility>
 
@@ -19,20 +20,6 @@ template <typename T>
 constexpr T max(T a, T b) { return a < b ? b : a; }
 
 
-/// Concatenates two tuple-like classes
-template <class U, class V>
-struct tuple_concat;
-
-template <
-    template <class...> class T,
-    class... Alist,
-    class... Blist
-> struct tuple_concat<T<Alist...>, T<Blist...>> { using type = T<Alist..., Blist...>; };
-
-template <typename U, typename V>
-using tuple_concat_t = typename tuple_concat<U,V>::type;
-
-
 /// Pushes type to tuple-like class
 template <class Tuple, class T>
 struct tuple_push;
@@ -55,6 +42,268 @@ template <typename T>
 using identity_t = typename identity<T>::type;
 
 
+/**
+ * Lazy conditional: only "type" of the selected metafunction is instantiated,
+ * unlike std::conditional<C, typename Then::type, typename Else::type>.
+ *      eval_if_t<found, identity<Node>, search<Sub,T>>
+ */
+template <bool Cond, typename Then, typename Else>
+struct eval_if { using type = typename Then::type; };
+
+template <typename Then, typename Else>
+struct eval_if<false, Then, Else> { using type = typename Else::type; };
+
+template <bool Cond, typename Then, typename Else>
+using eval_if_t = typename eval_if<Cond,Then,Else>::type;
+
+
+namespace bool_pack_impl {
+    template <bool... B>
+    struct bools {};
+}
+
+/// Conjunction of bool pack, O(1) depth and instantiations (no short-circuit)
+template <bool... B>
+struct all_true : std::is_same<bool_pack_impl::bools<true, B...>, bool_pack_impl::bools<B..., true>> {};
+
+/// Disjunction of bool pack, O(1) depth and instantiations (no short-circuit)
+template <bool... B>
+struct any_true : std::integral_constant<bool,
+    !std::is_same<bool_pack_impl::bools<false, B...>, bool_pack_impl::bools<B..., false>>::value> {};
+
+/// Every type of Lower is less than the type at the same position of Upper: Comp::lt<L, U>
+template <typename Comp, typename Lower, typename Upper>
+struct pairwise_less;
+
+template <typename Comp, class... L, class... U>
+struct pairwise_less<Comp, std::tuple<L...>, std::tuple<U...>> : all_true<Comp::template lt<L, U>::value...> {};
+
+
+/// Sequence of indices, C++11 analogue of std::index_sequence
+template <size_t... I>
+struct index_sequence { enum : size_t { size = sizeof...(I) }; };
+
+namespace index_sequence_impl {
+    
+    template <typename U, typename V>
+    struct join;
+    
+    /// Appends V (shifted by U::size) to U
+    template <size_t... I, size_t... J>
+    struct join<index_sequence<I...>, index_sequence<J...>> {
+        using type = index_sequence<I..., (sizeof...(I) + J)...>; };
+}
+
+/// Constructs index_sequence<0,...,N-1> by halving, O(log N) depth and instantiations
+template <size_t N>
+struct make_index_sequence {
+    using type = typename index_sequence_impl::join<
+        typename make_index_sequence<N/2>::type,
+        typename make_index_sequence<N - N/2>::type
+    >::type;
+};
+
+template <>
+struct make_index_sequence<0> { using type = index_sequence<>; };
+
+template <>
+struct make_index_sequence<1> { using type = index_sequence<0>; };
+
+template <size_t N>
+using make_index_sequence_t = typename make_index_sequence<N>::type;
+
+
+/// Contains I-th type of tuple-like class, O(1) depth (via overload resolution)
+template <typename Tuple, size_t I>
+struct tuple_at;
+
+namespace tuple_at_impl {
+    
+    template <size_t I, typename T>
+    struct indexed { using type = T; };
+    
+    template <typename Seq, typename... T>
+    struct indexer;
+    
+    /// Inherits every indexed<I,T>, instantiated once per tuple
+    template <size_t... I, typename... T>
+    struct indexer<index_sequence<I...>, T...> : indexed<I,T>... {};
+    
+    template <size_t I, typename T>
+    indexed<I,T> select(indexed<I,T> const*);
+}
+
+template <
+    template <class...> class Tuple,
+    class... Args,
+    size_t I
+> struct tuple_at<Tuple<Args...>, I> {
+    static_assert(I < sizeof...(Args), LOG_HEAD "tuple index out of range");
+private:
+    using indexer = tuple_at_impl::indexer<make_index_sequence_t<sizeof...(Args)>, Args...>;
+public:
+    using type = typename decltype(tuple_at_impl::select<I>(static_cast<indexer const*>(nullptr)))::type;
+};
+
+template <typename Tuple, size_t I>
+using tuple_at_t = typename tuple_at<Tuple,I>::type;
+
+
+/// Drops first N types of tuple-like class, O(1) depth and instantiations (via deduction)
+template <typename Tuple, size_t N>
+struct tuple_drop;
+
+namespace tuple_drop_impl {
+    
+    template <size_t I>
+    struct skip { using type = void const*; };
+    
+    template <typename Seq>
+    struct dropper;
+    
+    /// Swallows sizeof...(I) leading arguments, deduces the rest
+    template <size_t... I>
+    struct dropper<index_sequence<I...>> {
+        template <template <class...> class Tuple, typename... Rest>
+        static identity<Tuple<Rest...>> apply(typename skip<I>::type..., identity<Rest>*...);
+    };
+}
+
+template <
+    template <class...> class Tuple,
+    class... Args,
+    size_t N
+> struct tuple_drop<Tuple<Args...>, N> {
+    static_assert(N <= sizeof...(Args), LOG_HEAD "tuple drop out of range");
+    using type = typename decltype(
+        tuple_drop_impl::dropper<make_index_sequence_t<N>>::template apply<Tuple>(
+            static_cast<identity<Args>*>(nullptr)...)
+    )::type;
+};
+
+template <typename Tuple, size_t N>
+using tuple_drop_t = typename tuple_drop<Tuple,N>::type;
+
+
+/// Takes first N types of tuple-like class, O(1) depth and instantiations (N lookups in tuple_at indexer)
+template <typename Tuple, size_t N>
+struct tuple_take;
+
+namespace tuple_take_impl {
+    
+    template <typename Tuple, typename Seq, bool Whole>
+    struct take;
+    
+    template <template <class...> class Tuple, class... Args, typename Seq>
+    struct take<Tuple<Args...>, Seq, true> { using type = Tuple<Args...>; };
+    
+    /// Selects every I-th type by overload resolution against the same indexer as tuple_at
+    template <template <class...> class Tuple, class... Args, size_t... I>
+    struct take<Tuple<Args...>, index_sequence<I...>, false> {
+    private:
+        using indexer = tuple_at_impl::indexer<make_index_sequence_t<sizeof...(Args)>, Args...>;
+    public:
+        using type = Tuple<typename decltype(
+            tuple_at_impl::select<I>(static_cast<indexer const*>(nullptr)))::type...>;
+    };
+}
+
+template <
+    template <class...> class Tuple,
+    class... Args,
+    size_t N
+> struct tuple_take<Tuple<Args...>, N> {
+    static_assert(N <= sizeof...(Args), LOG_HEAD "tuple take out of range");
+    using type = typename tuple_take_impl::take<
+        Tuple<Args...>,
+        make_index_sequence_t<N == sizeof...(Args) ? 0 : N>,
+        N == sizeof...(Args)
+    >::type;
+};
+
+template <typename Tuple, size_t N>
+using tuple_take_t = typename tuple_take<Tuple,N>::type;
+
+/**
+ * Concatenates any number of tuple-like classes (of the same template), empty std::tuple<> for none.
+ * Joins up to 8 lists per instantiation, more than 1024 lists are split by halving:
+ * O(k/8) joins and depth bounded by 128 + O(log k).
+ */
+template <class... Tuples>
+struct tuple_concat;
+
+namespace tuple_concat_impl {
+    
+    /// Linear joining by batches of 8/4/2 lists
+    template <class... Tuples>
+    struct batches;
+    
+    template <>
+    struct batches<> { using type = std::tuple<>; };
+    
+    template <
+        template <class...> class T,
+        class... Alist
+    > struct batches<T<Alist...>> { using type = T<Alist...>; };
+    
+    template <
+        template <class...> class T,
+        class... Alist,
+        class... Blist,
+        class... Rest
+    > struct batches<T<Alist...>, T<Blist...>, Rest...> {
+        using type = typename batches<T<Alist..., Blist...>, Rest...>::type; };
+    
+    template <
+        template <class...> class T,
+        class... A1, class... A2, class... A3, class... A4,
+        class... Rest
+    > struct batches<T<A1...>, T<A2...>, T<A3...>, T<A4...>, Rest...> {
+        using type = typename batches<T<A1..., A2..., A3..., A4...>, Rest...>::type; };
+    
+    template <
+        template <class...> class T,
+        class... A1, class... A2, class... A3, class... A4,
+        class... A5, class... A6, class... A7, class... A8,
+        class... Rest
+    > struct batches<T<A1...>, T<A2...>, T<A3...>, T<A4...>, T<A5...>, T<A6...>, T<A7...>, T<A8...>, Rest...> {
+        using type = typename batches<T<A1..., A2..., A3..., A4..., A5..., A6..., A7..., A8...>, Rest...>::type; };
+    
+    enum : size_t { max_batches = 1024 };
+    
+    /// Splits std::tuple of lists in halves until linear joining is shallow enough
+    template <typename Lists, bool Flat = (std::tuple_size<Lists>::value <= max_batches)>
+    struct halving;
+    
+    template <class... Lists>
+    struct halving<std::tuple<Lists...>, true> { using type = typename batches<Lists...>::type; };
+    
+    template <class... Lists>
+    struct halving<std::tuple<Lists...>, false> {
+    private:
+        enum : size_t { half = sizeof...(Lists)/2 };
+    public:
+        using type = typename batches<
+            typename halving<tuple_take_t<std::tuple<Lists...>, half>>::type,
+            typename halving<tuple_drop_t<std::tuple<Lists...>, half>>::type
+        >::type;
+    };
+}
+
+template <class... Tuples>
+struct tuple_concat { using type = typename tuple_concat_impl::halving<std::tuple<Tuples...>>::type; };
+
+/// Shortcut for the most common pair case
+template <
+    template <class...> class T,
+    class... Alist,
+    class... Blist
+> struct tuple_concat<T<Alist...>, T<Blist...>> { using type = T<Alist..., Blist...>; };
+
+template <typename... Tuples>
+using tuple_concat_t = typename tuple_concat<Tuples...>::type;
+
+
 /**
  * Constructs new tuple by range [From,To) from Source, applies Mod to every element type.
  * @arg Source  - tuple to be transformed
@@ -65,6 +314,9 @@ using identity_t = typename identity<T>::type;
  * Examples:
  *      t.slice(A,B)    == tuple_transform_t<t,A,B>
  *      t.map(Func)     == tuple_transform_t<t, 0, t.size, Func>
+ * 
+ * Implemented by tuple_transform_indexed (default) or tuple_transform_linear
+ * (if AX_CT_LINEAR_TUPLE_TRANSFORM is defined), see below.
  */
 template <
     typename Source, size_t From, size_t To,
@@ -72,12 +324,19 @@ template <
     typename Acc = std::tuple<>
 > struct tuple_transform;
 
+/// Element-by-element implementation: O(N) depth, O(N^2) intermediate tuples
+template <
+    typename Source, size_t From, size_t To,
+    template <class> class Mod = identity,
+    typename Acc = std::tuple<>
+> struct tuple_transform_linear;
+
 template <typename Source, size_t I, template <class> class Mod, typename Acc>
-struct tuple_transform<Source,I,I,Mod,Acc> { using type = Acc; };
+struct tuple_transform_linear<Source,I,I,Mod,Acc> { using type = Acc; };
 
 template <typename Source, size_t A, size_t B, template <class> class Mod, typename Acc>
-struct tuple_transform {
-    using type = typename tuple_transform<
+struct tuple_transform_linear {
+    using type = typename tuple_transform_linear<
         Source, A + 1, B, Mod,
         tuple_push_t<
             Acc,
@@ -86,6 +345,40 @@ struct tuple_transform {
     >::type;
 };
 
+namespace tuple_transform_impl {
+    
+    template <template <class> class Mod, typename Acc, typename Slice>
+    struct expand;
+    
+    /// Applies Mod to the whole slice by single pack expansion
+    template <
+        template <class> class Mod,
+        template <class...> class Tuple, class... Args,
+        template <class...> class Slice, class... Items
+    > struct expand<Mod, Tuple<Args...>, Slice<Items...>> {
+        using type = Tuple<Args..., typename Mod<Items>::type...>; };
+}
+
+/// Index sequence based implementation (tuple_drop + tuple_take): O(log N) depth, O(N) instantiations
+template <
+    typename Source, size_t From, size_t To,
+    template <class> class Mod = identity,
+    typename Acc = std::tuple<>
+> struct tuple_transform_indexed {
+    static_assert(From <= To, LOG_HEAD "invalid transform range");
+    using type = typename tuple_transform_impl::expand<
+        Mod, Acc, tuple_take_t<tuple_drop_t<Source, From>, To - From>
+    >::type;
+};
+
+template <typename Source, size_t From, size_t To, template <class> class Mod, typename Acc>
+struct tuple_transform :
+#ifdef AX_CT_LINEAR_TUPLE_TRANSFORM
+    tuple_transform_linear<Source,From,To,Mod,Acc> {};
+#else
+    tuple_transform_indexed<Source,From,To,Mod,Acc> {};
+#endif
+
 template <
     typename Source, size_t From, size_t To,
     template <class> class Mod = identity,
@@ -117,6 +410,26 @@ public:
     using type = typename tuple_reduce<std::tuple<Tail...>,Fun,Acc_>::type;
 };
 
+/// Unrolled specialisation: folds 8 heads per instantiation, O(N/8) depth, same left-fold order
+template <
+    template <class,class> class Fun, class Acc,
+    typename T0, typename T1, typename T2, typename T3,
+    typename T4, typename T5, typename T6, typename T7,
+    typename... Tail
+> struct tuple_reduce<std::tuple<T0,T1,T2,T3,T4,T5,T6,T7,Tail...>,Fun,Acc> {
+private:
+    using Acc0 = typename Fun<Acc, T0>::type;
+    using Acc1 = typename Fun<Acc0,T1>::type;
+    using Acc2 = typename Fun<Acc1,T2>::type;
+    using Acc3 = typename Fun<Acc2,T3>::type;
+    using Acc4 = typename Fun<Acc3,T4>::type;
+    using Acc5 = typename Fun<Acc4,T5>::type;
+    using Acc6 = typename Fun<Acc5,T6>::type;
+    using Acc7 = typename Fun<Acc6,T7>::type;
+public:
+    using type = typename tuple_reduce<std::tuple<Tail...>,Fun,Acc7>::type;
+};
+
 template <
     class Source,
     template <class,class> class Fun,
@@ -125,6 +438,135 @@ template <
 using tuple_reduce_t = typename tuple_reduce<Source,Fun,Acc>::type;
 
 
+/**
+ * Pairwise (tree-shaped) reduction for associative Fun, O(log N) depth and O(N) instantiations:
+ *      Fun<Acc, Fun<Fun<T1,T2>, Fun<T3,T4>>>   ==   tuple_reduce_t<Source,Fun,Acc>
+ * @arg Source  - tuple to be reduced
+ * @arg Fun     - associative type operation, instantiates as Fun<U,V> for elements and partial results
+ * @arg Acc     - leftmost operand, used as result for empty Source; omitted if void (by default)
+ */
+template <
+    class Source,
+    template <class,class> class Fun,
+    class Acc = void
+> struct tuple_reduce_tree;
+
+namespace tuple_reduce_tree_impl {
+    
+    /// Folds first N types of Source
+    template <typename Source, template <class,class> class Fun, size_t N>
+    struct fold_first;
+    
+    template <
+        template <class...> class Tuple, class Head, class... Tail,
+        template <class,class> class Fun
+    > struct fold_first<Tuple<Head,Tail...>, Fun, 1> { using type = Head; };
+    
+    template <typename Source, template <class,class> class Fun, size_t N>
+    struct fold_first {
+        using type = typename Fun<
+            typename fold_first<Source, Fun, N/2>::type,
+            typename fold_first<tuple_drop_t<Source, N/2>, Fun, N - N/2>::type
+        >::type;
+    };
+    
+    template <typename Source, template <class,class> class Fun, typename Acc>
+    struct attach { using type = typename Fun<Acc, Source>::type; };
+    
+    template <typename Source, template <class,class> class Fun>
+    struct attach<Source, Fun, void> { using type = Source; };
+}
+
+template <template <class...> class Tuple, template <class,class> class Fun, class Acc>
+struct tuple_reduce_tree<Tuple<>,Fun,Acc> { using type = Acc; };
+
+template <template <class...> class Tuple, class... Args, template <class,class> class Fun, class Acc>
+struct tuple_reduce_tree<Tuple<Args...>,Fun,Acc> {
+    using type = typename tuple_reduce_tree_impl::attach<
+        typename tuple_reduce_tree_impl::fold_first<Tuple<Args...>, Fun, sizeof...(Args)>::type,
+        Fun, Acc
+    >::type;
+};
+
+template <
+    class Source,
+    template <class,class> class Fun,
+    class Acc = void
+>
+using tuple_reduce_tree_t = typename tuple_reduce_tree<Source,Fun,Acc>::type;
+
+
+/**
+ * Text of T::value as std::ostream writes it, computed at compile time into static array:
+ * characters (char, signed and unsigned char) as is, other integers and enums in decimal.
+ *      value_text<std::integral_constant<int,-42>>::str() == "-42", length == 3
+ */
+template <typename T, typename Indices = void>
+struct value_text;
+
+namespace value_text_impl {
+    
+    template <typename T>
+    using value_type = typename std::remove_cv<decltype(T::value)>::type;
+    
+    /// Values of integral and enumeration types are printed at compile time
+    template <typename T>
+    struct printable : std::integral_constant<bool,
+        std::is_integral<value_type<T>>::value || std::is_enum<value_type<T>>::value> {};
+    
+    template <typename V>
+    struct is_char : std::integral_constant<bool,
+        std::is_same<V, char>::value || std::is_same<V, signed char>::value || std::is_same<V, unsigned char>::value> {};
+    
+    /// Underlying type of enumerations
+    template <typename V>
+    using number_type = typename eval_if<std::is_enum<V>::value, std::underlying_type<V>, identity<V>>::type;
+    
+    constexpr size_t digits(unsigned long long m) { return m < 10 ? 1 : 1 + digits(m / 10); }
+    
+    constexpr unsigned long long pow10(size_t k) { return k == 0 ? 1 : 10 * pow10(k - 1); }
+    
+    /// Decimal digits of value, sign is taken from the highest bit of sign-extended value
+    template <typename T, bool Char = is_char<value_type<T>>::value>
+    struct source {
+        static_assert(printable<T>::value, LOG_HEAD "value_text supports integral and enumeration values only");
+        
+        using CharT = char;
+        
+        enum : unsigned long long { bits = static_cast<unsigned long long>(T::value) };
+        enum : bool { negative = std::is_signed<number_type<value_type<T>>>::value && (bits >> 63) != 0 };
+        enum : unsigned long long { magnitude = negative ? 0 - bits : bits };
+        enum : size_t { length = size_t(negative) + digits(magnitude) };
+        
+        constexpr static char at(size_t idx) {
+            return (negative && idx == 0) ? '-' : char('0' + magnitude / pow10(length - 1 - idx) % 10); }
+    };
+    
+    template <typename T>
+    struct source<T, true> {
+        using CharT = char;
+        
+        enum : size_t { length = 1 };
+        
+        constexpr static char at(size_t) { return static_cast<char>(T::value); }
+    };
+}
+
+template <typename T>
+struct value_text<T, void> : value_text<T, make_index_sequence_t<value_text_impl::source<T>::length>> {};
+
+template <typename T, size_t... I>
+struct value_text<T, index_sequence<I...>> : value_text_impl::source<T> {
+    static constexpr char text[sizeof...(I) + 1] = { value_text_impl::source<T>::at(I)..., '\0' };
+    
+    /// @returns null-terminated text, no runtime formatting
+    constexpr static char const* str() { return text; }
+};
+
+template <typename T, size_t... I>
+constexpr char value_text<T, index_sequence<I...>>::text[];
+
+
 } // ct
 } // ax
 
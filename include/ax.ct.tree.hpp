@@ -34,6 +34,96 @@ struct sizeof_comp : public eq_traits<sizeof_comp> {
     struct lt : std::integral_constant<bool, (sizeof(U) < sizeof(V))> {};
 };
 
+namespace type_order_impl {
+    /// Compiler-generated function signature spelling T, and its length
+    struct signature_t {
+        char const* str;
+        size_t size;
+    };
+    
+    template <typename T>
+    constexpr signature_t signature() {
+    #if defined(_MSC_VER) && !defined(__clang__)
+        return signature_t{__FUNCSIG__, sizeof(__FUNCSIG__) - 1};
+    #else
+        return signature_t{__PRETTY_FUNCTION__, sizeof(__PRETTY_FUNCTION__) - 1};
+    #endif
+    }
+    
+    using hash_type = unsigned long long;
+    
+    constexpr hash_type mix(hash_type a, hash_type b) {
+        return (a ^ (b + 0x9e3779b97f4a7c15ull + (a << 6) + (a >> 2))) * 1099511628211ull; }
+    
+    /// Order-sensitive hash of s[lo, hi), recursion depth is O(log(hi - lo)) to fit long names
+    constexpr hash_type hash(char const* s, size_t lo, size_t hi) {
+        return
+        (hi - lo <= 1) ? (
+            (14695981039346656037ull ^ (lo < hi ? static_cast<unsigned char>(s[lo]) : 0u)) * 1099511628211ull
+        ) : (
+            mix(hash(s, lo, lo + (hi - lo)/2), hash(s, lo + (hi - lo)/2, hi))
+        );
+    }
+    
+    /// First index in [lo, hi) where a and b differ, hi if none; depth O(log(hi - lo))
+    constexpr size_t mismatch(char const* a, char const* b, size_t lo, size_t hi);
+    
+    constexpr size_t mismatch_right(char const* a, char const* b, size_t left, size_t mid, size_t hi) {
+        return left != mid ? left : mismatch(a, b, mid, hi); }
+    
+    constexpr size_t mismatch(char const* a, char const* b, size_t lo, size_t hi) {
+        return
+        (hi - lo <= 1) ? (
+            (lo < hi && a[lo] != b[lo]) ? lo : hi
+        ) : (
+            mismatch_right(a, b, mismatch(a, b, lo, lo + (hi - lo)/2), lo + (hi - lo)/2, hi)
+        );
+    }
+    
+    /// Lexicographical "less" of signatures, terminating '\0' takes part in comparison
+    constexpr bool name_less(signature_t a, signature_t b, size_t i) {
+        return i <= ct::min(a.size, b.size) &&
+            static_cast<unsigned char>(a.str[i]) < static_cast<unsigned char>(b.str[i]); }
+    
+    constexpr bool name_less(signature_t a, signature_t b) {
+        return name_less(a, b, mismatch(a.str, b.str, 0, ct::min(a.size, b.size) + 1)); }
+} // type_order_impl
+
+/// Contains hash of T's name as spelled by compiler (stable for given compiler and version), O(len)
+template <typename T>
+struct type_hash : std::integral_constant<type_order_impl::hash_type, type_order_impl::hash(
+    type_order_impl::signature<T>().str, 0, type_order_impl::signature<T>().size)> {};
+
+namespace type_order_impl {
+    /// true if U and V are the same type or their names differ: only such types can be ordered
+    template <typename U, typename V>
+    struct distinguishable : std::integral_constant<bool, std::is_same<U,V>::value ||
+        name_less(signature<U>(), signature<V>()) || name_less(signature<V>(), signature<U>())> {};
+    
+    template <typename U, typename V, bool SameHash = type_hash<U>::value == type_hash<V>::value>
+    struct less : std::integral_constant<bool, (type_hash<U>::value < type_hash<V>::value)> {};
+    
+    template <typename U, typename V>
+    struct less<U, V, true> : std::integral_constant<bool, name_less(signature<U>(), signature<V>())> {
+        static_assert(distinguishable<U,V>::value,
+            LOG_HEAD "distinct types with the same name (e.g. lambdas or unnamed classes on some compilers) cannot be ordered");
+    };
+} // type_order_impl
+
+/**
+ * Contains "less" (lt) comparator defining total order on arbitrary types:
+ *      U < V   <=>   hash(U) < hash(V) || (hash(U) == hash(V) && name(U) < name(V))
+ * Distinct types with distinct names are never "equal", so they can share one tree (e.g. int and float).
+ * Distinct types spelled the same by compiler would compare "equal", comparing them fails with static_assert
+ * instead. Whether lambdas or unnamed classes of one scope are spelled the same depends on the compiler
+ * (gcc omits their source location, clang doesn't).
+ * Order is unspecified, but stable within one compiler version.
+ */
+struct type_comp : public eq_traits<type_comp> {
+    template <typename U, typename V>
+    struct lt : std::integral_constant<bool, type_order_impl::less<U,V>::value> {};
+};
+
 
 /// --- node, interface --- ///
 
@@ -45,7 +135,7 @@ struct height;
 template <typename Node>
 struct walk;
 
-/// Constructs tree string representation (for debuging), O(n)
+/// Writes tree representation (text picture, DOT or JSON) to stream, buffer or string, O(n)
 template <typename Node, typename Printer, size_t Depth = 0, size_t From = 0>
 struct print;
 
@@ -152,12 +242,11 @@ struct walk<NIL> { using type = std::tuple<>; };
 
 template <typename Node>
 struct walk {
-private:
-    using accL = typename walk<typename Node::LT>::type;
-    using accX = tuple_push_t<accL, typename Node::type>;
-    using accR = tuple_concat_t<accX, typename walk<typename Node::RT>::type>;
-public:
-    using type = accR;
+    using type = tuple_concat_t<
+        typename walk<typename Node::LT>::type,
+        std::tuple<typename Node::type>,
+        typename walk<typename Node::RT>::type
+    >;
 };
 
 template <typename Node>
@@ -186,27 +275,20 @@ namespace level_walk_impl {
         using type = tuple_concat_t<accL, accR>;
     };
     
-    template <typename Node, size_t level>
+    /// Joins all levels by single variadic concatenation
+    template <typename Node, typename Levels>
     struct level_walk_impl;
     
-    //template <size_t level> // seems like unnecessary
-    //struct level_walk_impl<NIL,level> { using type = std::tuple<>; };
-    
-    template <typename Node>
-    struct level_walk_impl<Node,0> { using type = std::tuple<>; };
-    
-    template <typename Node, size_t level>
-    struct level_walk_impl {
-        using prev = typename level_walk_impl<Node, level - 1>::type;
-        using type = tuple_concat_t<prev, typename collect_level<Node, level-1>::type>;
-    };
+    template <typename Node, size_t... level>
+    struct level_walk_impl<Node, index_sequence<level...>> {
+        using type = tuple_concat_t<std::tuple<>, typename collect_level<Node, level>::type...>; };
 }
 
 template <typename Node>
 struct level_walk {
     using type = typename level_walk_impl::level_walk_impl<
         Node,
-        height<Node>::value
+        make_index_sequence_t<height<Node>::value>
     >::type;
 };
 
@@ -218,65 +300,356 @@ template <typename Node, size_t level>
 using collect_level_t = typename level_walk_impl::collect_level<Node,level>::type;
 
 
+/// --- Eytzinger layout, runtime search --- ///
+
+/**
+ * Exports tree of number classes (T::number_type, T::value) to runtime array in
+ * Eytzinger (BFS of complete tree) order, for any tree shape: values are taken from
+ * inorder walk and permuted, O(n log^2 n) constexpr steps. Tree must not be NIL.
+ * 
+ * Contains:
+ *      type::values        - array, values[k-1] is heap node k (children 2k, 2k+1)
+ *      type::size          - number of values
+ *      type::rank(i)       - inorder (sorted) index of values[i]
+ *      type::lower_bound   - branchless search of first value not less than key
+ */
+template <typename Tree>
+struct eytzinger;
+
+namespace eytzinger_impl {
+    
+    /// Amount of nodes in subtree of heap node First (level of Width nodes) of n-node tree, O(log n)
+    constexpr size_t subtree_size(size_t first, size_t n, size_t width = 1) {
+        return first > n ? 0 : min(n - first + 1, width) + subtree_size(2*first, n, 2*width); }
+    
+    /// Inorder index of heap node k (1-based) of n-node complete tree, O(log^2 n)
+    constexpr size_t rank(size_t k, size_t n) {
+        return
+            k == 1      ? subtree_size(2, n) :
+            k % 2 == 1  ? rank(k/2, n) + 1 + subtree_size(2*k, n) :
+                          rank(k/2, n) - 1 - subtree_size(2*k + 1, n);
+    }
+    
+    template <typename Sorted, typename Seq>
+    struct layout;
+    
+    template <template <class...> class Tuple, class... Num, size_t... K>
+    struct layout<Tuple<Num...>, index_sequence<K...>> {
+    private:
+        using NumT = typename std::tuple_element<0, std::tuple<Num...>>::type::number_type;
+        
+        /// Heap node 16k (4 levels below k) is prefetched: 16 descendants, one or two cache lines
+        enum : size_t { prefetch_distance = 16 };
+        
+    public:
+        struct type {
+            enum : size_t { size = sizeof...(Num) };
+            
+            static constexpr const NumT sorted[] = { Num::value... };
+            static constexpr const NumT values[] = { sorted[eytzinger_impl::rank(K + 1, size)]... };
+            
+            static constexpr size_t rank(size_t i) { return eytzinger_impl::rank(i + 1, size); }
+            
+            /// @returns index (in values) of first value not less than key, size if there is none
+            static size_t lower_bound(NumT key) {
+                size_t k = 1;
+                while(k <= size) {
+                #if defined(__GNUC__)
+                    __builtin_prefetch(values + (min<size_t>(prefetch_distance*k, size) - 1));
+                #endif
+                    k = 2*k + (values[k - 1] < key);
+                }
+                
+                // k encodes descent path: last left turn (at the answer) and right turns after it are dropped
+                #if defined(__GNUC__)
+                    k >>= __builtin_ctzll(~static_cast<unsigned long long>(k)) + 1;
+                #else
+                    while(k & 1) k >>= 1;
+                    k >>= 1;
+                #endif
+                return k == 0 ? size : k - 1;
+            }
+        };
+    };
+    
+    template <template <class...> class Tuple, class... Num, size_t... K>
+    constexpr const typename layout<Tuple<Num...>, index_sequence<K...>>::NumT
+        layout<Tuple<Num...>, index_sequence<K...>>::type::sorted[];
+    
+    template <template <class...> class Tuple, class... Num, size_t... K>
+    constexpr const typename layout<Tuple<Num...>, index_sequence<K...>>::NumT
+        layout<Tuple<Num...>, index_sequence<K...>>::type::values[];
+}
+
+template <typename Tree>
+struct eytzinger {
+private:
+    using sorted = walk_t<Tree>;
+public:
+    using type = typename eytzinger_impl::layout<
+        sorted,
+        make_index_sequence_t<std::tuple_size<sorted>::value>
+    >::type;
+};
+
+template <typename Tree>
+using eytzinger_t = typename eytzinger<Tree>::type;
+
+
 /// --- print, O(n) --- ///
 
+/// Prints T::value from text computed at compile time (see value_text), streams other values
 struct value_printer {
     template <typename T>
-    static std::string str() {
+    using text = value_text<T>;
+    
+    template <typename T>
+    static std::string str() { return str<T>(value_text_impl::printable<T>{}); }
+    
+    template <typename T>
+    static void write(std::ostream& os) { write<T>(os, value_text_impl::printable<T>{}); }
+    
+private:
+    template <typename T>
+    static std::string str(std::true_type) { return std::string(text<T>::str(), text<T>::length); }
+    
+    template <typename T>
+    static std::string str(std::false_type) {
         std::ostringstream stream;
         stream << T::value;
         return stream.str();
     }
+    
+    template <typename T>
+    static void write(std::ostream& os, std::true_type) { os.write(text<T>::str(), text<T>::length); }
+    
+    template <typename T>
+    static void write(std::ostream& os, std::false_type) { os << T::value; }
 };
 
 struct sizeof_printer {
     template <typename T>
-    static std::string str() { return std::to_string(sizeof(T)); }
+    using text = value_text<std::integral_constant<size_t, sizeof(T)>>;
+    
+    template <typename T>
+    static std::string str() { return std::string(text<T>::str(), text<T>::length); }
+    
+    template <typename T>
+    static void write(std::ostream& os) { os.write(text<T>::str(), text<T>::length); }
 };
 
-template <typename Printer, size_t Depth, size_t From>
-struct print<NIL,Printer,Depth,From> { static std::string str() { return ""; } };
+/// Output formats of print
+enum class print_format {
+    text,   // ASCII picture with root on the left (default)
+    dot,    // Graphviz digraph
+    json    // nested {"value": ..., "left": ..., "right": ...} objects
+};
 
-template <typename Node, typename Printer, size_t Depth, size_t From>
-struct print {
-private:
+namespace print_impl {
+    
     enum : size_t { floor_length = 8 };
     
-    static auto has_left(...) ->
-    decltype(std::false_type());
+    /// Stream buffer over fixed storage, excess characters are dropped
+    class fixed_buf : public std::streambuf {
+    public:
+        fixed_buf(char* begin, size_t size) { setp(begin, begin + size); }
+        
+        size_t size() const { return static_cast<size_t>(pptr() - pbase()); }
+        void reset() { setp(pbase(), epptr()); }
+        
+    protected:
+        int_type overflow(int_type c) override { return traits_type::not_eof(c); }
+    };
     
-    template <typename Bush>
-    static auto has_left(Bush&&) ->
-    decltype(std::declval<typename Bush::LT::type>(), std::true_type());
+    /**
+     * Forwards characters to another buffer escaping '"', '\' and control characters
+     * (DOT and JSON strings): newline as "\n", other ones below 0x20 as "\u00XX"
+     */
+    class escape_buf : public std::streambuf {
+    public:
+        explicit escape_buf(std::streambuf* to) : to(to) {}
+        
+    protected:
+        int_type overflow(int_type c) override {
+            if(traits_type::eq_int_type(c, traits_type::eof()))
+                return traits_type::not_eof(c);
+            
+            char ch = traits_type::to_char_type(c);
+            if(ch == '\n')
+                return to->sputn("\\n", 2) == 2 ? c : traits_type::eof();
+            if(static_cast<unsigned char>(ch) < 0x20) {
+                char const hex[] = "0123456789abcdef";
+                char const code[] = { '\\', 'u', '0', '0', hex[(ch >> 4) & 0xF], hex[ch & 0xF] };
+                return to->sputn(code, 6) == 6 ? c : traits_type::eof();
+            }
+            if(ch == '"' || ch == '\\')
+                to->sputc('\\');
+            return to->sputc(ch);
+        }
+        
+    private:
+        std::streambuf* to;
+    };
     
-    static auto has_right(...) ->
-    decltype(std::false_type());
+    /// Uses Printer::write<T>(os) if provided, Printer::str<T>() otherwise
+    template <typename Printer, typename T>
+    auto write_value(std::ostream& os, int) -> decltype(Printer::template write<T>(os)) {
+        Printer::template write<T>(os); }
     
-    template <typename Bush>
-    static auto has_right(Bush&&) ->
-    decltype(std::declval<typename Bush::RT::type>(), std::true_type());
+    template <typename Printer, typename T>
+    void write_value(std::ostream& os, long) { os << Printer::template str<T>(); }
     
-public:
-    static std::string str() {
-        auto lp = print<typename Node::LT, Printer, Depth + 1, 1>::str();
-        auto rp = print<typename Node::RT, Printer, Depth + 1, 2>::str();
-        bool end = (lp.length() + rp.length() == 0);
+    /// State of one printing pass, shared by all nodes
+    struct context {
+        std::ostream& os;
         
-        char m[2][2] = {{' ','\\'},{'/','<'}};
+        char label[floor_length];
+        fixed_buf label_buf;
+        std::ostream label_stream;
         
-        auto next = std::string(1, m
-            [decltype(has_left (std::declval<Node>()))::value]
-            [decltype(has_right(std::declval<Node>()))::value]
-        );
-        //auto next = path<typename Node::LT, typename Node::RT>();
-        auto prev = std::string(From == 1 ? "/" : From == 2 ? "\\" : "");
+        escape_buf escaped_buf;
+        std::ostream escaped;
+        
+        bool first;
+        size_t next_id;
+        
+        explicit context(std::ostream& os) :
+            os(os),
+            label_buf(label, floor_length), label_stream(&label_buf),
+            escaped_buf(os.rdbuf()), escaped(&escaped_buf),
+            first(true), next_id(0) {}
+    };
+    
+    /// Compile-time line layout of Node drawn at Depth, reached From parent (0 - root, 1 - left, 2 - right)
+    template <typename Node, size_t Depth, size_t From>
+    struct layout {
+        enum : bool {
+            has_left  = !std::is_same<typename Node::LT, NIL>::value,
+            has_right = !std::is_same<typename Node::RT, NIL>::value
+        };
+        
+        enum : size_t { indent = (floor_length + 1) * Depth };
+        
+        enum : char {
+            filler = (has_left || has_right) ? '-' : ' ',
+            next = has_left ? (has_right ? '<' : '/') : (has_right ? '\\' : ' ')
+        };
+        
+        static constexpr char const* prefix() {
+            return From == 1 ? "/--{" : From == 2 ? "\\--{" : "--{"; }
+    };
+    
+    template <typename Node, typename Printer, size_t Depth, size_t From>
+    struct text {
+        using line = layout<Node, Depth, From>;
         
-        auto val = Printer::template str<typename Node::type>();
-        (val = prev + "--{" + val + "}").resize(floor_length, end ? ' ' : '-');
-        val += next;
-        val = std::string((floor_length + 1) * Depth, ' ') + val;
+        static void write(context& c) {
+            text<typename Node::LT, Printer, Depth + 1, 1>::write(c);
+            
+            if(!c.first)
+                c.os.put('\n');
+            c.first = false;
+            
+            for(size_t i = 0; i < line::indent; ++i)
+                c.os.put(' ');
+            
+            c.label_buf.reset();
+            c.label_stream << line::prefix();
+            write_value<Printer, typename Node::type>(c.label_stream, 0);
+            c.label_stream << '}';
+            
+            c.os.write(c.label, static_cast<std::streamsize>(c.label_buf.size()));
+            for(size_t i = c.label_buf.size(); i < floor_length; ++i)
+                c.os.put(static_cast<char>(line::filler));
+            c.os.put(static_cast<char>(line::next));
+            
+            text<typename Node::RT, Printer, Depth + 1, 2>::write(c);
+        }
+    };
+    
+    template <typename Printer, size_t Depth, size_t From>
+    struct text<NIL, Printer, Depth, From> { static void write(context&) {} };
+    
+    /// Writes node statement and the edge from its parent, sides are kept by ports
+    template <typename Node, typename Printer>
+    struct dot {
+        static void write(context& c, size_t parent, char const* port) {
+            size_t id = c.next_id++;
+            
+            if(port != nullptr)
+                c.os << "    n" << parent << " -> n" << id << " [tailport=" << port << "];\n";
+            
+            c.os << "    n" << id << " [label=\"";
+            write_value<Printer, typename Node::type>(c.escaped, 0);
+            c.os << "\"];\n";
+            
+            dot<typename Node::LT, Printer>::write(c, id, "sw");
+            dot<typename Node::RT, Printer>::write(c, id, "se");
+        }
+    };
+    
+    template <typename Printer>
+    struct dot<NIL, Printer> { static void write(context&, size_t, char const*) {} };
+    
+    template <typename Node, typename Printer>
+    struct json {
+        static void write(context& c) {
+            c.os << "{\"value\":\"";
+            write_value<Printer, typename Node::type>(c.escaped, 0);
+            c.os << "\",\"left\":";
+            json<typename Node::LT, Printer>::write(c);
+            c.os << ",\"right\":";
+            json<typename Node::RT, Printer>::write(c);
+            c.os << '}';
+        }
+    };
+    
+    template <typename Printer>
+    struct json<NIL, Printer> { static void write(context& c) { c.os << "null"; } };
+    
+} // print_impl
+
+/**
+ * Writes tree in one pass without intermediate strings, O(n).
+ * Printer provides static write<T>(std::ostream&) or str<T>() (see value_printer).
+ * Depth and From (0 - root, 1 - left, 2 - right) shift text picture of subtree.
+ */
+template <typename Node, typename Printer, size_t Depth, size_t From>
+struct print {
+    static std::ostream& write(std::ostream& os, print_format format = print_format::text) {
+        print_impl::context c(os);
+        switch(format) {
+            case print_format::text:
+                print_impl::text<Node, Printer, Depth, From>::write(c);
+                break;
+            case print_format::dot:
+                os << "digraph tree {\n";
+                print_impl::dot<Node, Printer>::write(c, 0, nullptr);
+                os << "}\n";
+                break;
+            case print_format::json:
+                print_impl::json<Node, Printer>::write(c);
+                break;
+        }
+        return os;
+    }
+    
+    /// Writes to buffer[0, size) truncating output, always null-terminated; @returns length written
+    static size_t write(char* buffer, size_t size, print_format format = print_format::text) {
+        if(size == 0)
+            return 0;
         
-        return lp + (lp.length() > 0 ? "\n" : "") + val + (rp.length() > 0 ? "\n" : "") + rp;
+        print_impl::fixed_buf buf(buffer, size - 1);
+        std::ostream os(&buf);
+        write(os, format);
+        buffer[buf.size()] = '\0';
+        return buf.size();
+    }
+    
+    static std::string str(print_format format = print_format::text) {
+        std::ostringstream stream;
+        write(stream, format);
+        return stream.str();
     }
 };
 
@@ -291,15 +664,16 @@ struct search<NIL,T,Comp> { using type = NIL; using tree = NIL; };
 
 template <typename Node, typename T, typename Comp>
 struct search {
-    using type = typename std::conditional<
+    /// Stops at found node, descends only to the chosen subtree
+    using type = eval_if_t<
         Comp::template eq<T, typename Node::type>::value,
-        Node,
-        typename search<typename std::conditional<
+        identity<Node>,
+        search<typename std::conditional<
             Comp::template lt<T, typename Node::type>::value,
             typename Node::LT,
             typename Node::RT
-        >::type, T, Comp>::type
-    >::type;
+        >::type, T, Comp>
+    >;
     
     using tree = Node;
 };
@@ -436,68 +810,38 @@ private:
     
     enum : size_t { children = children_amount<Tree>::value };
     
-    using key = typename min_node_t<
-        typename std::conditional<
-            is_equal && children == 2,
-            typename Tree::RT,
-            leaf<typename Tree::type, typename Tree::comp>
-        >::type
-    >::type;
+    /// Removed node with less than 2 children is replaced by its only subtree (or NIL)
+    using only_child = std::conditional<
+        std::is_same<typename Tree::LT, NIL>::value,
+        typename Tree::RT,
+        typename Tree::LT
+    >;
     
-    using recursive_call = typename remove<
-        typename std::conditional<
-            is_less,
-            typename Tree::LT,
-            typename std::conditional<
-                !is_equal || children == 2,
-                typename Tree::RT,
-                NIL
-            >::type
-        >::type,
-        typename std::conditional<
+    /// Otherwise node is rebuilt: key is replaced by inorder successor (if removed),
+    /// removing continues in one subtree only
+    struct rebuilt {
+    private:
+        using key = typename eval_if_t<
             is_equal,
+            min_node<typename Tree::RT>,
+            identity<Tree>
+        >::type;
+        
+        using subtree = typename remove<
+            typename std::conditional<is_less, typename Tree::LT, typename Tree::RT>::type,
+            typename std::conditional<is_equal, key, T>::type
+        >::type;
+    public:
+        using type = node<
             key,
-            T
-        >::type
-    >::type;
-    
-    // TODO: unacceptable if c-tors are deleted, but more simple
-    static auto root_dispatcher(...) ->
-    typename Tree::RT;
-    
-    template <typename Bush>
-    static auto root_dispatcher(Bush&&) ->
-    decltype(typename Bush::LT::type(), typename Bush::LT());
-    //*/
-    
-    /*/! Common solution, pretty overkill, but general
-    static typename Tree::RT
-    root_dispatcher(...);
-    
-    template <typename Bush>
-    static typename std::enable_if<sizeof(typename Bush::LT::type), typename Bush::LT>::type
-    root_dispatcher(Bush&&);
-    //*/
+            typename std::conditional<is_less, subtree, typename Tree::LT>::type,
+            typename std::conditional<is_less, typename Tree::RT, subtree>::type,
+            typename Tree::comp
+        >;
+    };
     
 public:
-    using type = typename std::conditional<
-        is_equal && (children < 2),
-        decltype(root_dispatcher(std::declval<Tree>())),
-        node<
-            key,
-            typename std::conditional<
-                is_less,
-                recursive_call,
-                typename Tree::LT
-            >::type,
-            typename std::conditional<
-                !is_less,
-                recursive_call,
-                typename Tree::RT
-            >::type,
-            typename Tree::comp
-        >
-    >::type;
+    using type = eval_if_t<is_equal && (children < 2), only_child, rebuilt>;
 };
 
 template <typename Tree, typename T>
@@ -516,6 +860,1482 @@ public:
 template <typename Tree, typename Tuple>
 using remove_tuple_t = typename remove_tuple<Tree,Tuple>::type;
 
+
+/// --- bulk construction, O(n) --- ///
+
+/**
+ * Constructs perfectly balanced tree from sorted tuple by recursive midpoint splitting:
+ * O(n) instantiations, O(log n) depth (middle types are looked up via tuple_at)
+ */
+template <typename Sorted, typename Comp = sizeof_comp>
+struct build_balanced;
+
+namespace build_impl {
+    
+    /// Middle types are selected from Indexer directly: no tuple pack is deduced per node
+    template <typename Indexer, typename Comp, size_t From, size_t To>
+    struct build_range {
+    private:
+        enum : size_t { mid = From + (To - From)/2 };
+    public:
+        using type = node<
+            typename decltype(tuple_at_impl::select<mid>(static_cast<Indexer const*>(nullptr)))::type,
+            typename build_range<Indexer, Comp, From, mid>::type,
+            typename build_range<Indexer, Comp, mid + 1, To>::type,
+            Comp
+        >;
+    };
+    
+    template <typename Indexer, typename Comp, size_t I>
+    struct build_range<Indexer, Comp, I, I> { using type = NIL; };
+}
+
+template <template <class...> class Tuple, class... Args, typename Comp>
+struct build_balanced<Tuple<Args...>, Comp> {
+    using type = typename build_impl::build_range<
+        tuple_at_impl::indexer<make_index_sequence_t<sizeof...(Args)>, Args...>,
+        Comp, 0, sizeof...(Args)
+    >::type;
+};
+
+template <typename Sorted, typename Comp = sizeof_comp>
+using build_balanced_t = typename build_balanced<Sorted, Comp>::type;
+
+
+/**
+ * Stable merge of two sorted tuples, O(n) instantiations, O(log n) depth: the longer range
+ * is split at its middle type, which is placed by binary search in the other one, short
+ * ranges are merged linearly. Types are selected from one indexer per tuple, though
+ * compilers still match every selection against all indexer bases (O(n) work each)
+ */
+template <typename A, typename B, typename Comp>
+struct merge_sorted;
+
+/// Stable type-level merge sort, O(n log n) comparisons and instantiations, O(log^2 n) depth
+template <typename Tuple, typename Comp>
+struct merge_sort;
+
+namespace sort_impl {
+    
+    /// Indexer over types of Tuple: built once, selected by any number of probes
+    template <typename Tuple>
+    struct indexer_of;
+    
+    template <template <class...> class Tuple, class... T>
+    struct indexer_of<Tuple<T...>> {
+        using type = tuple_at_impl::indexer<make_index_sequence_t<sizeof...(T)>, T...>; };
+    
+    template <typename Tuple>
+    using indexer_of_t = typename indexer_of<Tuple>::type;
+    
+    /// Index of first type of Indexer[From,To) which is not less (Upper: greater) than T
+    template <typename Indexer, typename T, typename Comp, bool Upper, size_t From, size_t To>
+    struct bound {
+    private:
+        enum : size_t { mid = From + (To - From)/2 };
+        using X = typename decltype(tuple_at_impl::select<mid>(static_cast<Indexer const*>(nullptr)))::type;
+        enum : bool { go_right = Upper ? !Comp::template lt<T, X>::value : Comp::template lt<X, T>::value };
+    public:
+        enum : size_t { value = std::conditional<
+            go_right,
+            bound<Indexer, T, Comp, Upper, mid + 1, To>,
+            bound<Indexer, T, Comp, Upper, From, mid>
+        >::type::value };
+    };
+    
+    template <typename Indexer, typename T, typename Comp, bool Upper, size_t I>
+    struct bound<Indexer, T, Comp, Upper, I, I> { enum : size_t { value = I }; };
+    
+    /// Merges linearly, heads are moved to Out: one comparison per type
+    template <typename Comp, typename Out, typename As, typename Bs>
+    struct linear;
+    
+    template <typename Comp, template <class...> class Tuple, class... Out, class... As>
+    struct linear<Comp, Tuple<Out...>, Tuple<As...>, Tuple<>> { using type = Tuple<Out..., As...>; };
+    
+    template <typename Comp, template <class...> class Tuple, class... Out, typename B, class... Bs>
+    struct linear<Comp, Tuple<Out...>, Tuple<>, Tuple<B, Bs...>> { using type = Tuple<Out..., B, Bs...>; };
+    
+    /// Equal types of A precede ones of B
+    template <typename Comp, template <class...> class Tuple, class... Out, typename A, class... As, typename B, class... Bs>
+    struct linear<Comp, Tuple<Out...>, Tuple<A, As...>, Tuple<B, Bs...>> : std::conditional<
+        Comp::template lt<B, A>::value,
+        linear<Comp, Tuple<Out..., B>, Tuple<A, As...>, Tuple<Bs...>>,
+        linear<Comp, Tuple<Out..., A>, Tuple<As...>, Tuple<B, Bs...>>
+    >::type {};
+    
+    /// Types of Indexer[From, From + sizeof...(I)) as Tuple
+    template <template <class...> class Tuple, typename Indexer, size_t From, typename Seq>
+    struct slice;
+    
+    template <template <class...> class Tuple, typename Indexer, size_t From, size_t... I>
+    struct slice<Tuple, Indexer, From, index_sequence<I...>> {
+        using type = Tuple<typename decltype(
+            tuple_at_impl::select<From + I>(static_cast<Indexer const*>(nullptr)))::type...>;
+    };
+    
+    /// Both operands of one merge: indexers are built once, ranges are merged by their bounds
+    template <template <class...> class Tuple, typename IA, typename IB, typename Comp>
+    struct operands {
+        template <class... T>
+        using tuple = Tuple<T...>;
+        
+        template <size_t From, size_t To>
+        using slice_a = typename slice<Tuple, IA, From, make_index_sequence_t<To - From>>::type;
+        
+        template <size_t From, size_t To>
+        using slice_b = typename slice<Tuple, IB, From, make_index_sequence_t<To - From>>::type;
+        
+        template <size_t I>
+        using at_a = typename decltype(tuple_at_impl::select<I>(static_cast<IA const*>(nullptr)))::type;
+        
+        template <size_t I>
+        using at_b = typename decltype(tuple_at_impl::select<I>(static_cast<IB const*>(nullptr)))::type;
+        
+        using comp = Comp;
+        using ia = IA;
+        using ib = IB;
+    };
+    
+    enum : size_t { linear_size = 64 };
+    
+    /**
+     * Merges A[A0,A1) with B[B0,B1): the longer range is split at its middle type, placed by
+     * binary search in the other one, ranges up to linear_size types are merged linearly
+     */
+    template <typename Ops, size_t A0, size_t A1, size_t B0, size_t B1,
+        int Mode = (A1 - A0 + B1 - B0 <= linear_size || A0 == A1 || B0 == B1) ? 0 : (A1 - A0 >= B1 - B0) ? 1 : 2>
+    struct merge : linear<typename Ops::comp, typename Ops::template tuple<>,
+        typename Ops::template slice_a<A0, A1>, typename Ops::template slice_b<B0, B1>> {};
+    
+    /// Middle of A is placed before equal types of B (lower bound)
+    template <typename Ops, size_t A0, size_t A1, size_t B0, size_t B1>
+    struct merge<Ops, A0, A1, B0, B1, 1> {
+    private:
+        enum : size_t { mid = A0 + (A1 - A0)/2 };
+        using pivot = typename Ops::template at_a<mid>;
+        enum : size_t { at = bound<typename Ops::ib, pivot, typename Ops::comp, false, B0, B1>::value };
+    public:
+        using type = tuple_concat_t<
+            typename merge<Ops, A0, mid, B0, at>::type,
+            typename Ops::template tuple<pivot>,
+            typename merge<Ops, mid + 1, A1, at, B1>::type
+        >;
+    };
+    
+    /// Middle of B is placed after equal types of A (upper bound)
+    template <typename Ops, size_t A0, size_t A1, size_t B0, size_t B1>
+    struct merge<Ops, A0, A1, B0, B1, 2> {
+    private:
+        enum : size_t { mid = B0 + (B1 - B0)/2 };
+        using pivot = typename Ops::template at_b<mid>;
+        enum : size_t { at = bound<typename Ops::ia, pivot, typename Ops::comp, true, A0, A1>::value };
+    public:
+        using type = tuple_concat_t<
+            typename merge<Ops, A0, at, B0, mid>::type,
+            typename Ops::template tuple<pivot>,
+            typename merge<Ops, at, A1, mid + 1, B1>::type
+        >;
+    };
+    
+    template <typename Tuple, typename Comp, bool Trivial>
+    struct sort { using type = Tuple; };
+    
+    template <typename Tuple, typename Comp>
+    struct sort<Tuple, Comp, false> {
+    private:
+        enum : size_t { half = std::tuple_size<Tuple>::value/2 };
+    public:
+        using type = typename merge_sorted<
+            typename merge_sort<tuple_take_t<Tuple, half>, Comp>::type,
+            typename merge_sort<tuple_drop_t<Tuple, half>, Comp>::type,
+            Comp
+        >::type;
+    };
+}
+
+template <template <class...> class Tuple, class... As, class... Bs, typename Comp>
+struct merge_sorted<Tuple<As...>, Tuple<Bs...>, Comp> {
+    using type = typename sort_impl::merge<
+        sort_impl::operands<Tuple, sort_impl::indexer_of_t<Tuple<As...>>, sort_impl::indexer_of_t<Tuple<Bs...>>, Comp>,
+        0, sizeof...(As), 0, sizeof...(Bs)
+    >::type;
+};
+
+template <typename A, typename B, typename Comp>
+using merge_sorted_t = typename merge_sorted<A, B, Comp>::type;
+
+template <template <class...> class Tuple, class... Args, typename Comp>
+struct merge_sort<Tuple<Args...>, Comp> {
+    using type = typename sort_impl::sort<Tuple<Args...>, Comp, (sizeof...(Args) < 2)>::type; };
+
+template <typename Tuple, typename Comp>
+using merge_sort_t = typename merge_sort<Tuple, Comp>::type;
+
+/// Constructs balanced tree from unsorted tuple (merge_sort + build_balanced)
+template <typename Tuple, typename Comp = sizeof_comp>
+using build_t = build_balanced_t<merge_sort_t<Tuple, Comp>, Comp>;
+
+
+/// --- dispatch, runtime key => type --- ///
+
+namespace dispatch_impl {
+    
+    template <typename T, typename F>
+    void call(F& f) { f(identity<T>()); }
+    
+    /**
+     * Unrolled comparison tree over balanced Node built from sorted types, depth log2(n).
+     * Every function is named by its subtree only: O(n log n) total length of symbols
+     */
+    template <typename Node>
+    struct branch {
+    private:
+        using T = typename Node::type;
+    public:
+        template <typename Key, typename F>
+        static bool apply(Key key, F& f) {
+            return
+                key < T::value ? branch<typename Node::LT>::apply(key, f) :
+                T::value < key ? branch<typename Node::RT>::apply(key, f) :
+                (call<T>(f), true);
+        }
+    };
+    
+    template <>
+    struct branch<NIL> {
+        template <typename Key, typename F>
+        static bool apply(Key, F&) { return false; }
+    };
+    
+    /// Jump table for contiguous keys: single range check and indirect call
+    template <typename Sorted>
+    struct table;
+    
+    template <template <class...> class Tuple, class... T>
+    struct table<Tuple<T...>> {
+    private:
+        using first = tuple_at_t<Tuple<T...>, 0>;
+    public:
+        template <typename Key, typename F>
+        static bool apply(Key key, F& f) {
+            using handler = void(*)(F&);
+            static constexpr handler handlers[] = { &call<T, F>... };
+            
+            auto i = static_cast<size_t>(key - first::value);
+            return i < sizeof...(T) ? (handlers[i](f), true) : false;
+        }
+    };
+    
+    template <typename Sorted, size_t N = std::tuple_size<Sorted>::value>
+    struct is_dense : std::integral_constant<bool,
+        static_cast<size_t>(tuple_at_t<Sorted, N - 1>::value - tuple_at_t<Sorted, 0>::value) == N - 1> {};
+    
+    template <typename Sorted>
+    struct is_dense<Sorted, 0> : std::false_type {};
+    
+    /// Orders node types by T::value (tree comparator may order them differently)
+    struct value_less {
+        template <typename U, typename V>
+        struct lt : std::integral_constant<bool, (U::value < V::value)> {};
+    };
+    
+    /// Every value is less than the next one: O(n) instantiations
+    template <typename Walk, size_t N = std::tuple_size<Walk>::value>
+    struct increasing : pairwise_less<value_less, tuple_take_t<Walk, N - 1>, tuple_drop_t<Walk, 1>> {};
+    
+    template <typename Walk>
+    struct increasing<Walk, 0> : std::true_type {};
+    
+    /// Inorder walk sorted by T::value, merge sort only if the walk is not sorted already
+    template <typename Tree, typename Walk = walk_t<Tree>>
+    struct by_value {
+        using type = typename eval_if<increasing<Walk>::value,
+            identity<Walk>, merge_sort<Walk, value_less>>::type;
+        
+        static_assert(increasing<type>::value, LOG_HEAD "dispatch requires distinct T::value of tree nodes");
+    };
+}
+
+/**
+ * Dispatches runtime key to f(identity<T>()), T is type of node with T::value == key.
+ * Expands to balanced comparison tree (or jump table for contiguous keys) over inorder
+ * walk sorted by T::value, no runtime data structure is used. Tree types may carry
+ * handlers along with value.
+ * @returns false if key is not found
+ */
+template <typename Tree, typename Key, typename F>
+bool dispatch(Key key, F&& f) {
+    using sorted = typename dispatch_impl::by_value<Tree>::type;
+    return std::conditional<
+        dispatch_impl::is_dense<sorted>::value,
+        dispatch_impl::table<sorted>,
+        dispatch_impl::branch<build_balanced_t<sorted>>
+    >::type::apply(key, f);
+}
+
+
+
+/**
+ * Self-balancing (AVL) operations over the same node<> types, height is kept O(log n).
+ * Node height is a function of node type (height<> is instantiated once per node),
+ * so rebalancing costs O(1) per rebuilt node; all other algorithms (search, walk,
+ * level_walk, print, tree_eq, ...) work on AVL trees as is.
+ */
+namespace avl {
+
+/// Checks AVL invariant for every node, O(n)
+template <typename Tree>
+struct is_balanced;
+
+template <>
+struct is_balanced<NIL> : std::true_type {};
+
+template <typename Tree>
+struct is_balanced : std::integral_constant<bool,
+    height<typename Tree::LT>::value <= height<typename Tree::RT>::value + 1 &&
+    height<typename Tree::RT>::value <= height<typename Tree::LT>::value + 1 &&
+    is_balanced<typename Tree::LT>::value &&
+    is_balanced<typename Tree::RT>::value
+> {};
+
+
+/// --- rotations, O(1) --- ///
+
+template <typename Tree>
+struct rotate_right;
+
+template <typename X, typename Y, typename A, typename B, typename C, typename Comp>
+struct rotate_right<node<X, node<Y,A,B,Comp>, C, Comp>> { using type = node<Y, A, node<X,B,C,Comp>, Comp>; };
+
+template <typename Tree>
+struct rotate_left;
+
+template <typename X, typename Y, typename A, typename B, typename C, typename Comp>
+struct rotate_left<node<X, A, node<Y,B,C,Comp>, Comp>> { using type = node<Y, node<X,A,B,Comp>, C, Comp>; };
+
+/// Restores AVL invariant of node whose subtrees heights differ at most by 2
+template <typename Tree>
+struct rebalance {
+private:
+    using L = typename Tree::LT;
+    using R = typename Tree::RT;
+    
+    /// Left-right case: left child is rotated first
+    struct rotate_left_right {
+        using type = typename rotate_right<
+            node<typename Tree::type, typename rotate_left<L>::type, R, typename Tree::comp>
+        >::type;
+    };
+    
+    /// Right-left case: right child is rotated first
+    struct rotate_right_left {
+        using type = typename rotate_left<
+            node<typename Tree::type, L, typename rotate_right<R>::type, typename Tree::comp>
+        >::type;
+    };
+    
+    struct left_heavy {
+        using type = eval_if_t<
+            (height<typename L::RT>::value > height<typename L::LT>::value),
+            rotate_left_right,
+            rotate_right<Tree>
+        >;
+    };
+    
+    struct right_heavy {
+        using type = eval_if_t<
+            (height<typename R::LT>::value > height<typename R::RT>::value),
+            rotate_right_left,
+            rotate_left<Tree>
+        >;
+    };
+    
+public:
+    using type = eval_if_t<
+        (height<L>::value > height<R>::value + 1),
+        left_heavy,
+        eval_if<
+            (height<R>::value > height<L>::value + 1),
+            right_heavy,
+            identity<Tree>
+        >
+    >;
+};
+
+
+/// --- insert, O(log n) --- ///
+
+/// Pushes type to Tree keeping it balanced (equal types go right, as for plain insert)
+template <typename Tree, typename T, typename Comp = typename Tree::comp>
+struct insert;
+
+template <typename T, typename Comp>
+struct insert<NIL,T,Comp> { using type = leaf<T,Comp>; };
+
+template <typename Tree, typename T, typename Comp>
+struct insert {
+private:
+    static constexpr bool is_left = Comp::template lt<T, typename Tree::type>::value;
+    
+    using modified_subtree = typename insert<
+        typename std::conditional<is_left, typename Tree::LT, typename Tree::RT>::type,
+        T,
+        Comp
+    >::type;
+public:
+    using type = typename rebalance<node<
+        typename Tree::type,
+        typename std::conditional<is_left, modified_subtree, typename Tree::LT>::type,
+        typename std::conditional<is_left, typename Tree::RT, modified_subtree>::type,
+        Comp
+    >>::type;
+};
+
+template <typename Tree, typename T, typename Comp = typename Tree::comp>
+using insert_t = typename insert<Tree,T,Comp>::type;
+
+/// Inserts batch (tuple) of types to Tree
+template <typename Tree, typename Tuple, typename Comp = typename Tree::comp>
+struct insert_tuple {
+private:
+    template <typename Acc, typename T>
+    struct inserter { using type = insert_t<Acc, T, Comp>; };
+public:
+    using type = tuple_reduce_t<Tuple, inserter, Tree>;
+};
+
+template <typename Tree, typename Tuple, typename Comp = typename Tree::comp>
+using insert_tuple_t = typename insert_tuple<Tree,Tuple,Comp>::type;
+
+
+/// --- remove, O(log n) --- ///
+
+/// Removes node with given T from Tree keeping it balanced
+template <typename Tree, typename T>
+struct remove;
+
+template <typename T>
+struct remove<NIL,T> { using type = NIL; };
+
+template <typename Tree, typename T>
+struct remove {
+private:
+    static constexpr bool is_less  = Tree::comp::template lt<T, typename Tree::type>::value;
+    static constexpr bool is_equal = Tree::comp::template eq<T, typename Tree::type>::value;
+    
+    using only_child = std::conditional<
+        std::is_same<typename Tree::LT, NIL>::value,
+        typename Tree::RT,
+        typename Tree::LT
+    >;
+    
+    /// Key is replaced by inorder successor (if removed), removing continues in one subtree only
+    struct rebuilt {
+    private:
+        using key = typename eval_if_t<
+            is_equal,
+            min_node<typename Tree::RT>,
+            identity<Tree>
+        >::type;
+        
+        using subtree = typename remove<
+            typename std::conditional<is_less, typename Tree::LT, typename Tree::RT>::type,
+            typename std::conditional<is_equal, key, T>::type
+        >::type;
+    public:
+        using type = typename rebalance<node<
+            key,
+            typename std::conditional<is_less, subtree, typename Tree::LT>::type,
+            typename std::conditional<is_less, typename Tree::RT, subtree>::type,
+            typename Tree::comp
+        >>::type;
+    };
+    
+public:
+    using type = eval_if_t<is_equal && (children_amount<Tree>::value < 2), only_child, rebuilt>;
+};
+
+template <typename Tree, typename T>
+using remove_t = typename remove<Tree, T>::type;
+
+/// Removes batch (tuple) of types from Tree
+template <typename Tree, typename Tuple>
+struct remove_tuple {
+private:
+    template <typename Acc, typename T>
+    struct remover { using type = remove_t<Acc, T>; };
+public:
+    using type = tuple_reduce_t<Tuple, remover, Tree>;
+};
+
+template <typename Tree, typename Tuple>
+using remove_tuple_t = typename remove_tuple<Tree,Tuple>::type;
+
+} // avl
+
+
+/// --- B-tree, O(log_Order n) height --- ///
+
+/// B-tree node: sorted keys pack and (for inner nodes) keys + 1 children
+template <typename Keys, typename Children = std::tuple<>>
+struct bnode {
+    using keys      = Keys;
+    using children  = Children;
+};
+
+/**
+ * Type-level B-tree: every node (except root) holds from Order/2 to Order keys in flat
+ * pack, so height is O(log_Order n) and insert/remove rebuild O(log_Order n) nodes.
+ * Same interface as node<>: height, walk, search (contains bnode<> with found key),
+ * insert, remove, insert_tuple, remove_tuple. Equal keys go right as for node<>.
+ *      using set = insert_tuple_t<btree<16, num_comp>, input>;
+ */
+template <size_t Order, typename Comp = sizeof_comp, typename Root = NIL>
+struct btree {
+    static_assert(Order >= 2, LOG_HEAD "B-tree order must be at least 2");
+    
+    enum : size_t { order = Order };
+    using comp  = Comp;     // types comparator
+    using root  = Root;     // root bnode<> or NIL
+    
+    template <typename Tree = btree>
+    using height = std::integral_constant<size_t, height<Tree>::value>;
+    
+    template <typename Tree = btree>
+    using inorder_traversal = typename walk<Tree>::type;
+    
+    template <typename U>
+    using find = typename search<btree, U, comp>::type;
+    
+    template <typename U>
+    using insert = typename insert<btree, U, comp>::type;
+    
+    template <typename U>
+    using erase = typename remove<btree, U>::type;
+};
+
+/// Checks B-tree invariants: keys amount, equal leaves depth, keys order, O(n)
+template <typename Tree>
+struct is_valid_btree;
+
+namespace btree_impl {
+    
+    constexpr size_t count() { return 0; }
+    
+    /// Amount of true arguments
+    template <typename... Rest>
+    constexpr size_t count(bool head, Rest... rest) { return head + count(rest...); }
+    
+    /// Replaces N types of Tuple starting from I by types of Insert
+    template <typename Tuple, size_t I, size_t N, typename Insert>
+    using splice_t = tuple_concat_t<tuple_take_t<Tuple, I>, Insert, tuple_drop_t<Tuple, I + N>>;
+    
+    template <bool Replace>
+    struct pick { template <typename New, typename Old> using type = Old; };
+    
+    template <>
+    struct pick<true> { template <typename New, typename Old> using type = New; };
+    
+    template <typename Tuple, size_t I, typename T, typename Seq>
+    struct replace;
+    
+    template <template <class...> class Tuple, class... Args, size_t I, typename T, size_t... K>
+    struct replace<Tuple<Args...>, I, T, index_sequence<K...>> {
+        using type = Tuple<typename pick<K == I>::template type<T, Args>...>; };
+    
+    /// Replaces I-th type of Tuple by T, single pack expansion (cheaper than splice_t)
+    template <typename Tuple, size_t I, typename T>
+    using replace_t = typename replace<Tuple, I, T, make_index_sequence_t<std::tuple_size<Tuple>::value>>::type;
+    
+    /// tuple_take/tuple_drop of children, leaf children (empty) stay empty
+    template <typename Children, size_t N>
+    using take_children_t = eval_if_t<std::tuple_size<Children>::value == 0, identity<Children>, tuple_take<Children, N>>;
+    
+    template <typename Children, size_t N>
+    using drop_children_t = eval_if_t<std::tuple_size<Children>::value == 0, identity<Children>, tuple_drop<Children, N>>;
+    
+    template <typename Node>
+    struct key_count : std::tuple_size<typename Node::keys> {};
+    
+    template <typename Node>
+    struct is_leaf : std::integral_constant<bool, std::tuple_size<typename Node::children>::value == 0> {};
+    
+    /// Number of keys of I-th child, 0 if there is no such child
+    template <typename Children, size_t I, bool Exists = (I < std::tuple_size<Children>::value)>
+    struct child_keys : std::integral_constant<size_t, 0> {};
+    
+    template <typename Children, size_t I>
+    struct child_keys<Children, I, true> : key_count<tuple_at_t<Children, I>> {};
+    
+    /// Number of keys less than T, binary search: O(log Order) comparisons
+    template <typename Keys, typename T, typename Comp>
+    using lower = sort_impl::bound<sort_impl::indexer_of_t<Keys>, T, Comp, false, 0, std::tuple_size<Keys>::value>;
+    
+    /// Number of keys not greater than T (position of inserted T)
+    template <typename Keys, typename T, typename Comp>
+    using upper = sort_impl::bound<sort_impl::indexer_of_t<Keys>, T, Comp, true, 0, std::tuple_size<Keys>::value>;
+    
+    /// I-th key equals T (false if I is out of range)
+    template <typename Keys, size_t I, typename T, typename Comp, bool Exists = (I < std::tuple_size<Keys>::value)>
+    struct key_eq : std::integral_constant<bool, Comp::template eq<tuple_at_t<Keys, I>, T>::value> {};
+    
+    template <typename Keys, size_t I, typename T, typename Comp>
+    struct key_eq<Keys, I, T, Comp, false> : std::false_type {};
+    
+    
+    template <typename Node>
+    struct node_height;
+    
+    template <typename Keys>
+    struct node_height<bnode<Keys, std::tuple<>>> : std::integral_constant<size_t, 1> {};
+    
+    template <typename Keys, typename C0, typename... C>
+    struct node_height<bnode<Keys, std::tuple<C0, C...>>> :
+        std::integral_constant<size_t, 1 + node_height<C0>::value> {};
+    
+    
+    /// Children and keys interleaving
+    template <typename Node>
+    struct walk_node;
+    
+    template <typename... K>
+    struct walk_node<bnode<std::tuple<K...>, std::tuple<>>> { using type = std::tuple<K...>; };
+    
+    template <typename... K, typename C0, typename... C>
+    struct walk_node<bnode<std::tuple<K...>, std::tuple<C0, C...>>> {
+        using type = tuple_concat_t<
+            typename walk_node<C0>::type,
+            tuple_concat_t<std::tuple<K>, typename walk_node<C>::type>...
+        >;
+    };
+    
+    
+    /// Leftmost key of subtree
+    template <typename Node>
+    struct min_key;
+    
+    template <typename K0, typename... K>
+    struct min_key<bnode<std::tuple<K0, K...>, std::tuple<>>> { using type = K0; };
+    
+    template <typename Keys, typename C0, typename... C>
+    struct min_key<bnode<Keys, std::tuple<C0, C...>>> { using type = typename min_key<C0>::type; };
+    
+    
+    /// Contains node holding key equal to T, NIL if there is no such key
+    template <typename Node, typename T, typename Comp>
+    struct search_node {
+    private:
+        using keys = typename Node::keys;
+        enum : size_t { i = lower<keys, T, Comp>::value };
+        
+        struct descend { using type = typename search_node<tuple_at_t<typename Node::children, i>, T, Comp>::type; };
+    public:
+        using type = eval_if_t<
+            key_eq<keys, i, T, Comp>::value,
+            identity<Node>,
+            eval_if<is_leaf<Node>::value, identity<NIL>, descend>
+        >;
+    };
+    
+    template <typename T, typename Comp>
+    struct search_node<NIL, T, Comp> { using type = NIL; };
+    
+    
+    /// Overflowed node (Order + 1 keys) is split around median: tuple<Left, Median, Right>
+    template <typename Node, size_t Order, bool Overflow = (key_count<Node>::value > Order)>
+    struct split { using type = std::tuple<Node>; };
+    
+    template <typename Node, size_t Order>
+    struct split<Node, Order, true> {
+    private:
+        enum : size_t { m = (Order + 1)/2 };
+        using keys      = typename Node::keys;
+        using children  = typename Node::children;
+    public:
+        using type = std::tuple<
+            bnode<tuple_take_t<keys, m>, take_children_t<children, m + 1>>,
+            tuple_at_t<keys, m>,
+            bnode<tuple_drop_t<keys, m + 1>, drop_children_t<children, m + 1>>
+        >;
+    };
+    
+    /// Keys and children replacing inserted child: tuple<Node> or split tuple<Left, Median, Right>
+    template <typename Result>
+    struct parts;
+    
+    template <typename N>
+    struct parts<std::tuple<N>> {
+        using keys      = std::tuple<>;
+        using children  = std::tuple<N>;
+        using root      = N;
+    };
+    
+    template <typename L, typename M, typename R>
+    struct parts<std::tuple<L, M, R>> {
+        using keys      = std::tuple<M>;
+        using children  = std::tuple<L, R>;
+        using root      = bnode<keys, children>;
+    };
+    
+    /// Inserts T into leaf, overflowed nodes are split on the way back (see "split")
+    template <typename Node, typename T, typename Comp, size_t Order>
+    struct insert_node {
+    private:
+        using keys      = typename Node::keys;
+        using children  = typename Node::children;
+        enum : size_t { i = upper<keys, T, Comp>::value };
+        
+        struct into_leaf { using type = bnode<splice_t<keys, i, 0, std::tuple<T>>>; };
+        
+        /// Split child adds its median to keys, otherwise child is just replaced
+        struct into_child {
+        private:
+            using result = typename insert_node<tuple_at_t<children, i>, T, Comp, Order>::type;
+            
+            struct grown {
+                using type = bnode<
+                    splice_t<keys, i, 0, typename parts<result>::keys>,
+                    splice_t<children, i, 1, typename parts<result>::children>
+                >;
+            };
+        public:
+            using type = eval_if_t<
+                std::tuple_size<result>::value == 1,
+                identity<bnode<keys, replace_t<children, i, tuple_at_t<result, 0>>>>,
+                grown
+            >;
+        };
+    public:
+        using type = typename split<eval_if_t<is_leaf<Node>::value, into_leaf, into_child>, Order>::type;
+    };
+    
+    
+    /// Restores keys amount of J-th child after removal: borrows key from sibling or merges with it
+    template <typename Node, size_t J, size_t Order>
+    struct fix {
+    private:
+        using keys      = typename Node::keys;
+        using children  = typename Node::children;
+        using C         = tuple_at_t<children, J>;
+        
+        enum : size_t { min_keys = Order/2 };
+        
+        /// Last key of left sibling goes up, separator J-1 goes down to child
+        struct rotate_right {
+        private:
+            using L = tuple_at_t<children, J - 1>;
+            enum : size_t { n = key_count<L>::value };
+            
+            using new_L = bnode<tuple_take_t<typename L::keys, n - 1>, take_children_t<typename L::children, n>>;
+            using new_C = bnode<
+                tuple_concat_t<std::tuple<tuple_at_t<keys, J - 1>>, typename C::keys>,
+                tuple_concat_t<drop_children_t<typename L::children, n>, typename C::children>
+            >;
+        public:
+            using type = bnode<
+                splice_t<keys, J - 1, 1, std::tuple<tuple_at_t<typename L::keys, n - 1>>>,
+                splice_t<children, J - 1, 2, std::tuple<new_L, new_C>>
+            >;
+        };
+        
+        /// First key of right sibling goes up, separator J goes down to child
+        struct rotate_left {
+        private:
+            using R = tuple_at_t<children, J + 1>;
+            
+            using new_C = bnode<
+                tuple_concat_t<typename C::keys, std::tuple<tuple_at_t<keys, J>>>,
+                tuple_concat_t<typename C::children, take_children_t<typename R::children, 1>>
+            >;
+            using new_R = bnode<tuple_drop_t<typename R::keys, 1>, drop_children_t<typename R::children, 1>>;
+        public:
+            using type = bnode<
+                splice_t<keys, J, 1, std::tuple<tuple_at_t<typename R::keys, 0>>>,
+                splice_t<children, J, 2, std::tuple<new_C, new_R>>
+            >;
+        };
+        
+        /// Children K, K+1 and separator K are merged into single child
+        template <size_t K>
+        struct merge {
+        private:
+            using A = tuple_at_t<children, K>;
+            using B = tuple_at_t<children, K + 1>;
+            
+            using merged = bnode<
+                tuple_concat_t<typename A::keys, std::tuple<tuple_at_t<keys, K>>, typename B::keys>,
+                tuple_concat_t<typename A::children, typename B::children>
+            >;
+        public:
+            using type = bnode<splice_t<keys, K, 1, std::tuple<>>, splice_t<children, K, 2, std::tuple<merged>>>;
+        };
+        
+    public:
+        using type = eval_if_t<
+            (key_count<C>::value >= min_keys),
+            identity<Node>,
+            eval_if<(child_keys<children, J - 1>::value > min_keys), rotate_right,
+            eval_if<(child_keys<children, J + 1>::value > min_keys), rotate_left,
+            eval_if<(J > 0), merge<J - 1>, merge<J>>>>
+        >;
+    };
+    
+    /// Removes T from subtree, node may become underfull (fixed by parent)
+    template <typename Node, typename T, typename Comp, size_t Order>
+    struct remove_node {
+    private:
+        using keys      = typename Node::keys;
+        using children  = typename Node::children;
+        enum : size_t { i = lower<keys, T, Comp>::value };
+        enum : bool { found = key_eq<keys, i, T, Comp>::value };
+        
+        struct erased { using type = bnode<splice_t<keys, i, 1, std::tuple<>>>; };
+        
+        /// Found key is replaced by inorder successor, which is removed from right child then
+        struct from_inner {
+        private:
+            struct successor { using type = typename min_key<tuple_at_t<children, i + 1>>::type; };
+            using target = eval_if_t<found, successor, identity<T>>;
+            
+            struct replaced { using type = replace_t<keys, i, target>; };
+            
+            enum : size_t { j = found ? i + 1 : i };
+            using child = typename remove_node<tuple_at_t<children, j>, target, Comp, Order>::type;
+        public:
+            using type = typename fix<
+                bnode<eval_if_t<found, replaced, identity<keys>>, replace_t<children, j, child>>,
+                j,
+                Order
+            >::type;
+        };
+    public:
+        using type = eval_if_t<
+            is_leaf<Node>::value,
+            eval_if<found, erased, identity<Node>>,
+            from_inner
+        >;
+    };
+    
+    /// Root without keys is replaced by its only child (or NIL)
+    template <typename Node>
+    struct shrink { using type = Node; };
+    
+    template <>
+    struct shrink<bnode<std::tuple<>>> { using type = NIL; };
+    
+    template <typename C>
+    struct shrink<bnode<std::tuple<>, std::tuple<C>>> { using type = C; };
+    
+    
+    template <typename A, typename B, typename Comp>
+    struct ordered;
+    
+    /// Neighbours A[i] <= B[i]
+    template <typename... A, typename... B, typename Comp>
+    struct ordered<std::tuple<A...>, std::tuple<B...>, Comp> :
+        std::integral_constant<bool, count(Comp::template lt<B, A>::value...) == 0> {};
+    
+    template <typename Node, size_t Order, size_t MinKeys>
+    struct valid_node;
+    
+    template <typename Keys, size_t Order, size_t MinKeys>
+    struct valid_node<bnode<Keys, std::tuple<>>, Order, MinKeys> : std::integral_constant<bool,
+        (std::tuple_size<Keys>::value >= MinKeys && std::tuple_size<Keys>::value <= Order)> {};
+    
+    template <typename Keys, typename C0, typename... C, size_t Order, size_t MinKeys>
+    struct valid_node<bnode<Keys, std::tuple<C0, C...>>, Order, MinKeys> : std::integral_constant<bool,
+        std::tuple_size<Keys>::value >= MinKeys && std::tuple_size<Keys>::value <= Order &&
+        sizeof...(C) == std::tuple_size<Keys>::value &&
+        count(node_height<C>::value != node_height<C0>::value...) == 0 &&
+        valid_node<C0, Order, Order/2>::value &&
+        count(!valid_node<C, Order, Order/2>::value...) == 0
+    > {};
+}
+
+template <size_t Order, typename Comp>
+struct height<btree<Order, Comp, NIL>> : std::integral_constant<size_t, 0> {};
+
+template <size_t Order, typename Comp, typename Root>
+struct height<btree<Order, Comp, Root>> : btree_impl::node_height<Root> {};
+
+template <size_t Order, typename Comp>
+struct walk<btree<Order, Comp, NIL>> { using type = std::tuple<>; };
+
+template <size_t Order, typename Comp, typename Root>
+struct walk<btree<Order, Comp, Root>> { using type = typename btree_impl::walk_node<Root>::type; };
+
+template <size_t Order, typename Comp, typename Root, typename T, typename C>
+struct search<btree<Order, Comp, Root>, T, C> {
+    using type = typename btree_impl::search_node<Root, T, C>::type;
+    using tree = btree<Order, Comp, Root>;
+};
+
+template <size_t Order, typename Comp, typename T, typename C>
+struct insert<btree<Order, Comp, NIL>, T, C> { using type = btree<Order, Comp, bnode<std::tuple<T>>>; };
+
+/// Root split grows tree by one level
+template <size_t Order, typename Comp, typename Root, typename T, typename C>
+struct insert<btree<Order, Comp, Root>, T, C> {
+    using type = btree<Order, Comp, typename btree_impl::parts<
+        typename btree_impl::insert_node<Root, T, C, Order>::type
+    >::root>;
+};
+
+template <size_t Order, typename Comp, typename T>
+struct remove<btree<Order, Comp, NIL>, T> { using type = btree<Order, Comp, NIL>; };
+
+template <size_t Order, typename Comp, typename Root, typename T>
+struct remove<btree<Order, Comp, Root>, T> {
+    using type = btree<Order, Comp, typename btree_impl::shrink<
+        typename btree_impl::remove_node<Root, T, Comp, Order>::type
+    >::type>;
+};
+
+template <size_t Order, typename Comp>
+struct is_valid_btree<btree<Order, Comp, NIL>> : std::true_type {};
+
+template <size_t Order, typename Comp, typename Root>
+struct is_valid_btree<btree<Order, Comp, Root>> : std::integral_constant<bool,
+    btree_impl::valid_node<Root, Order, 1>::value &&
+    btree_impl::ordered<
+        tuple_take_t<walk_t<btree<Order, Comp, Root>>, std::tuple_size<walk_t<btree<Order, Comp, Root>>>::value - 1>,
+        tuple_drop_t<walk_t<btree<Order, Comp, Root>>, 1>,
+        Comp
+    >::value
+> {};
+
+
+/// --- order statistics and ranges, O(h) --- ///
+/// size, rank, select and lower_bound/upper_bound work on node<> trees only, range_walk on btree<> too
+
+/// Contains amount of keys in tree, instantiated once per node type (like height), O(n)
+template <typename Tree>
+struct size;
+
+template <>
+struct size<NIL> : std::integral_constant<size_t, 0> {};
+
+template <typename T, typename L, typename R, typename C>
+struct size<node<T, L, R, C>> : std::integral_constant<size_t, 1 + size<L>::value + size<R>::value> {};
+
+/// Contains amount of keys less than T (dense index of T if tree contains it), O(h)
+template <typename Tree, typename T, typename Comp = typename Tree::comp>
+struct rank;
+
+template <typename T, typename Comp>
+struct rank<NIL, T, Comp> : std::integral_constant<size_t, 0> {};
+
+template <typename Tree, typename T, typename Comp>
+struct rank {
+private:
+    enum : bool { go_right = Comp::template lt<typename Tree::type, T>::value };
+    
+    struct right : std::integral_constant<size_t,
+        size<typename Tree::LT>::value + 1 + rank<typename Tree::RT, T, Comp>::value> {};
+public:
+    enum : size_t { value = std::conditional<go_right, right, rank<typename Tree::LT, T, Comp>>::type::value };
+};
+
+/// Contains node holding K-th (0-based) smallest key, NIL if K >= size, O(h)
+template <typename Tree, size_t K>
+struct select;
+
+template <size_t K>
+struct select<NIL, K> { using type = NIL; };
+
+template <typename Tree, size_t K>
+struct select {
+private:
+    enum : size_t { left = size<typename Tree::LT>::value };
+    
+    struct right { using type = typename select<typename Tree::RT, K - left - 1>::type; };
+public:
+    using type = eval_if_t<
+        (K < left),
+        select<typename Tree::LT, K>,
+        eval_if<K == left, identity<Tree>, right>
+    >;
+};
+
+/// Contains node holding first key not less (Upper: greater) than T, NIL if there is none, O(h)
+template <typename Tree, typename T, typename Comp = typename Tree::comp, bool Upper = false>
+struct lower_bound;
+
+template <typename T, typename Comp, bool Upper>
+struct lower_bound<NIL, T, Comp, Upper> { using type = NIL; };
+
+template <typename Tree, typename T, typename Comp, bool Upper>
+struct lower_bound {
+private:
+    enum : bool { go_right = Upper ?
+        !Comp::template lt<T, typename Tree::type>::value :
+         Comp::template lt<typename Tree::type, T>::value };
+    
+    /// Current node is the answer if left subtree has none
+    struct left {
+    private:
+        using found = typename lower_bound<typename Tree::LT, T, Comp, Upper>::type;
+    public:
+        using type = typename std::conditional<std::is_same<found, NIL>::value, Tree, found>::type;
+    };
+public:
+    using type = eval_if_t<go_right, lower_bound<typename Tree::RT, T, Comp, Upper>, left>;
+};
+
+template <typename Tree, typename T, typename Comp = typename Tree::comp>
+using upper_bound = lower_bound<Tree, T, Comp, true>;
+
+/// Sorted keys of tree inside [Lo, Hi) (NIL bound is unbounded), visits only O(h + k) nodes
+template <typename Tree, typename Lo, typename Hi, typename Comp = typename Tree::comp>
+struct range_walk;
+
+namespace range_walk_impl {
+    
+    /// Lo <= T (NIL is unbounded)
+    template <typename Lo, typename T, typename Comp>
+    struct above : std::integral_constant<bool, !Comp::template lt<T, Lo>::value> {};
+    
+    template <typename T, typename Comp>
+    struct above<NIL, T, Comp> : std::true_type {};
+    
+    /// T < Hi (NIL is unbounded)
+    template <typename T, typename Hi, typename Comp>
+    struct below : std::integral_constant<bool, Comp::template lt<T, Hi>::value> {};
+    
+    template <typename T, typename Comp>
+    struct below<T, NIL, Comp> : std::true_type {};
+    
+    /// Keys inside [Lo, Hi)
+    template <typename Tree, typename Lo, typename Hi, typename Comp>
+    struct range;
+    
+    template <typename Lo, typename Hi, typename Comp>
+    struct range<NIL, Lo, Hi, Comp> { using type = std::tuple<>; };
+    
+    /// Left subtree (keys <= T) is skipped if T is before Lo, right one (keys >= T) if T >= Hi
+    template <typename T, typename L, typename R, typename C, typename Lo, typename Hi, typename Comp>
+    struct range<node<T, L, R, C>, Lo, Hi, Comp> {
+    private:
+        enum : bool { go_left = above<Lo, T, Comp>::value };
+        enum : bool { go_right = below<T, Hi, Comp>::value };
+        
+        struct left     { using type = typename range<L, Lo, Hi, Comp>::type; };
+        struct right    { using type = typename range<R, Lo, Hi, Comp>::type; };
+    public:
+        using type = tuple_concat_t<
+            eval_if_t<go_left, left, identity<std::tuple<>>>,
+            typename std::conditional<go_left && go_right, std::tuple<T>, std::tuple<>>::type,
+            eval_if_t<go_right, right, identity<std::tuple<>>>
+        >;
+    };
+    
+    /// I-th child keys lie in [Keys[I-1], Keys[I]], it is skipped if Keys[I] is before Lo or Keys[I-1] >= Hi
+    template <typename Node, typename Lo, typename Hi, typename Comp, typename Seq>
+    struct range_bnode;
+    
+    template <typename Keys, typename Children, typename Lo, typename Hi, typename Comp, size_t... I>
+    struct range_bnode<bnode<Keys, Children>, Lo, Hi, Comp, index_sequence<I...>> {
+    private:
+        enum : size_t { n = std::tuple_size<Keys>::value };
+        
+        /// J-th key (if any): type is tuple of it if it lies inside range
+        template <size_t J, bool IsKey = (J < n)>
+        struct key {
+        private:
+            using K = tuple_at_t<Keys, J>;
+        public:
+            enum : bool { after_lo = above<Lo, K, Comp>::value };
+            using type = typename std::conditional<
+                after_lo && below<K, Hi, Comp>::value, std::tuple<K>, std::tuple<>>::type;
+        };
+        
+        template <size_t J>
+        struct key<J, false> {
+            enum : bool { after_lo = true };
+            using type = std::tuple<>;
+        };
+        
+        template <size_t J>
+        struct child { using type = typename range<tuple_at_t<Children, J>, Lo, Hi, Comp>::type; };
+        
+        template <size_t J, bool First = (J == 0)>
+        struct visited : std::integral_constant<bool,
+            key<J>::after_lo && below<tuple_at_t<Keys, J - 1>, Hi, Comp>::value> {};
+        
+        template <size_t J>
+        struct visited<J, true> : std::integral_constant<bool, key<J>::after_lo> {};
+        
+        template <size_t J>
+        struct piece {
+            using type = tuple_concat_t<
+                eval_if_t<!btree_impl::is_leaf<bnode<Keys, Children>>::value && visited<J>::value,
+                    child<J>, identity<std::tuple<>>>,
+                typename key<J>::type
+            >;
+        };
+    public:
+        using type = tuple_concat_t<std::tuple<>, typename piece<I>::type...>;
+    };
+    
+    template <typename Keys, typename Children, typename Lo, typename Hi, typename Comp>
+    struct range<bnode<Keys, Children>, Lo, Hi, Comp> : range_bnode<
+        bnode<Keys, Children>, Lo, Hi, Comp, make_index_sequence_t<std::tuple_size<Keys>::value + 1>> {};
+    
+    template <size_t Order, typename C, typename Root, typename Lo, typename Hi, typename Comp>
+    struct range<btree<Order, C, Root>, Lo, Hi, Comp> : range<Root, Lo, Hi, Comp> {};
+}
+
+template <typename Tree, typename Lo, typename Hi, typename Comp>
+struct range_walk { using type = typename range_walk_impl::range<Tree, Lo, Hi, Comp>::type; };
+
+template <typename Tree, typename T, typename Comp = typename Tree::comp>
+using rank_t = std::integral_constant<size_t, rank<Tree, T, Comp>::value>;
+
+template <typename Tree, size_t K>
+using select_t = typename select<Tree, K>::type;
+
+template <typename Tree, typename T, typename Comp = typename Tree::comp>
+using lower_bound_t = typename lower_bound<Tree, T, Comp>::type;
+
+template <typename Tree, typename T, typename Comp = typename Tree::comp>
+using upper_bound_t = typename upper_bound<Tree, T, Comp>::type;
+
+template <typename Tree, typename Lo, typename Hi, typename Comp = typename Tree::comp>
+using range_walk_t = typename range_walk<Tree, Lo, Hi, Comp>::type;
+
+
+/// --- set algebra, O(n+m) instantiations --- ///
+
+namespace set_impl {
+    
+    /// Which keys are kept: of A without (own) and with (common) equal key in B, of B without one
+    template <bool AOwn, bool ACommon, bool BOwn>
+    struct policy { enum : bool { a_own = AOwn, a_common = ACommon, b_own = BOwn }; };
+    
+    using union_policy                = policy<true,  true,  true >;
+    using intersection_policy         = policy<false, true,  false>;
+    using difference_policy           = policy<true,  false, false>;
+    using symmetric_difference_policy = policy<true,  false, true >;
+    
+    template <typename Policy, bool FromA, bool Common>
+    struct keeps : std::integral_constant<bool, FromA ?
+        (Common ? bool(Policy::a_common) : bool(Policy::a_own)) :
+        (!Common && bool(Policy::b_own))> {};
+    
+    /// Appends T to Out if it is kept
+    template <typename Out, bool Keep, typename T>
+    struct append { using type = Out; };
+    
+    template <class... Out, typename T>
+    struct append<std::tuple<Out...>, true, T> { using type = std::tuple<Out..., T>; };
+    
+    template <typename Policy, bool FromA, bool Common, typename Out, typename T>
+    using emit = typename append<Out, keeps<Policy, FromA, Common>::value, T>::type;
+    
+    /// T equals the last consumed key of the other tree (NIL if none): keys are consumed in order
+    template <typename Comp, typename T, typename Last>
+    struct equals_last : Comp::template eq<T, Last> {};
+    
+    template <typename Comp, typename T>
+    struct equals_last<Comp, T, NIL> : std::false_type {};
+    
+    /// Head of Sorted is not greater than X
+    template <typename Comp, typename X, typename Sorted>
+    struct fits : std::false_type {};
+    
+    template <typename Comp, typename X, typename T, class... Ts>
+    struct fits<Comp, X, std::tuple<T, Ts...>> : std::integral_constant<bool, !Comp::template lt<X, T>::value> {};
+    
+    /// Which head goes first: 1 - of A, 2 - of B, 3 - equal ones
+    template <typename Comp, typename As, typename Bs>
+    struct first : std::integral_constant<int, 0> {};
+    
+    template <typename Comp, typename A, class... As, typename B, class... Bs>
+    struct first<Comp, std::tuple<A, As...>, std::tuple<B, Bs...>> : std::integral_constant<int,
+        Comp::template lt<B, A>::value ? 2 : Comp::template lt<A, B>::value ? 1 : 3> {};
+    
+    /**
+     * Linear merge of small sorted batches As and Bs, keys not greater than X are consumed.
+     * Kept keys are appended to Out, LastA and LastB are the last consumed keys
+     */
+    template <typename Policy, typename Comp, typename X, typename LastA, typename LastB, typename Out, typename As, typename Bs,
+        int Take = fits<Comp, X, As>::value ?
+            (fits<Comp, X, Bs>::value ? first<Comp, As, Bs>::value : 1) :
+            (fits<Comp, X, Bs>::value ? 2 : 0)>
+    struct batch {
+        using type = Out;
+        using last_a = LastA;
+        using last_b = LastB;
+        enum : size_t { rest_a = std::tuple_size<As>::value, rest_b = std::tuple_size<Bs>::value };
+    };
+    
+    template <typename Policy, typename Comp, typename X, typename LastA, typename LastB, typename Out, typename A, class... As, typename Bs>
+    struct batch<Policy, Comp, X, LastA, LastB, Out, std::tuple<A, As...>, Bs, 1> : batch<
+        Policy, Comp, X, A, LastB,
+        emit<Policy, true, equals_last<Comp, A, LastB>::value, Out, A>,
+        std::tuple<As...>, Bs> {};
+    
+    template <typename Policy, typename Comp, typename X, typename LastA, typename LastB, typename Out, typename As, typename B, class... Bs>
+    struct batch<Policy, Comp, X, LastA, LastB, Out, As, std::tuple<B, Bs...>, 2> : batch<
+        Policy, Comp, X, LastA, B,
+        emit<Policy, false, equals_last<Comp, B, LastA>::value, Out, B>,
+        As, std::tuple<Bs...>> {};
+    
+    template <typename Policy, typename Comp, typename X, typename LastA, typename LastB, typename Out,
+        typename A, class... As, typename B, class... Bs>
+    struct batch<Policy, Comp, X, LastA, LastB, Out, std::tuple<A, As...>, std::tuple<B, Bs...>, 3> : batch<
+        Policy, Comp, X, A, B,
+        emit<Policy, false, true, emit<Policy, true, true, Out, A>, B>,
+        std::tuple<As...>, std::tuple<Bs...>> {};
+    
+    /// The lesser of the last keys of both batches (NIL stands for an exhausted tree)
+    template <typename Comp, typename LA, typename LB>
+    struct limit : std::conditional<Comp::template lt<LB, LA>::value, LB, LA> {};
+    
+    template <typename Comp, typename LA>
+    struct limit<Comp, LA, NIL> { using type = LA; };
+    
+    template <typename Comp, typename LB>
+    struct limit<Comp, NIL, LB> { using type = LB; };
+    
+    template <typename Indexer, size_t I, size_t N>
+    struct last_of { using type = typename decltype(tuple_at_impl::select<I + N - 1>(static_cast<Indexer const*>(nullptr)))::type; };
+    
+    template <typename Indexer, size_t I>
+    struct last_of<Indexer, I, 0> { using type = NIL; };
+    
+    enum : size_t { batch_size = 64 };
+    
+    /**
+     * Merge of sorted walks from positions I and J: up to batch_size heads of both are sliced
+     * from indexers per step and merged up to the lesser of their last keys, so every step
+     * consumes at least one full batch (or the rest of a walk): (n+m)/batch_size steps
+     */
+    template <typename Policy, typename Comp, typename IA, typename IB, size_t NA, size_t NB,
+        size_t I = 0, size_t J = 0, typename LastA = NIL, typename LastB = NIL, bool Done = I == NA && J == NB>
+    struct merge {
+    private:
+        enum : size_t {
+            na = ct::min(size_t(batch_size), NA - I),
+            nb = ct::min(size_t(batch_size), NB - J)
+        };
+        
+        using step = batch<Policy, Comp,
+            typename limit<Comp, typename last_of<IA, I, na>::type, typename last_of<IB, J, nb>::type>::type,
+            LastA, LastB, std::tuple<>,
+            typename sort_impl::slice<std::tuple, IA, I, make_index_sequence_t<na>>::type,
+            typename sort_impl::slice<std::tuple, IB, J, make_index_sequence_t<nb>>::type>;
+        using next = merge<Policy, Comp, IA, IB, NA, NB,
+            I + na - step::rest_a, J + nb - step::rest_b, typename step::last_a, typename step::last_b>;
+    public:
+        using type = tuple_concat_t<typename step::type, typename next::type>;
+    };
+    
+    template <typename Policy, typename Comp, typename IA, typename IB, size_t NA, size_t NB,
+        size_t I, size_t J, typename LastA, typename LastB>
+    struct merge<Policy, Comp, IA, IB, NA, NB, I, J, LastA, LastB, true> { using type = std::tuple<>; };
+    
+    template <typename Policy, typename A, typename B, typename Comp,
+        typename WA = walk_t<A>, typename WB = walk_t<B>>
+    using merge_t = build_balanced_t<typename merge<Policy, Comp,
+        sort_impl::indexer_of_t<WA>, sort_impl::indexer_of_t<WB>,
+        std::tuple_size<WA>::value, std::tuple_size<WB>::value>::type, Comp>;
+}
+
+/**
+ * Set operations on two trees (node<>, AVL or btree<>), result is balanced node<> tree.
+ * Inorder walks of both trees are merged linearly in batches of 64 keys (see set_impl::merge):
+ * O(n+m) comparisons and instantiations (each key is still selected from an indexer, which
+ * compilers resolve by scanning its bases), then the result is rebuilt by build_balanced.
+ * Keys of A take precedence over equal keys of B, duplicates inside one tree are kept.
+ *      using features = set_union_t<base_features, extra_features>;
+ */
+template <typename A, typename B, typename Comp = typename A::comp>
+struct set_union {
+    using type = set_impl::merge_t<set_impl::union_policy, A, B, Comp>; };
+
+template <typename A, typename B, typename Comp = typename A::comp>
+struct set_intersection {
+    using type = set_impl::merge_t<set_impl::intersection_policy, A, B, Comp>; };
+
+template <typename A, typename B, typename Comp = typename A::comp>
+struct set_difference {
+    using type = set_impl::merge_t<set_impl::difference_policy, A, B, Comp>; };
+
+template <typename A, typename B, typename Comp = typename A::comp>
+struct set_symmetric_difference {
+    using type = set_impl::merge_t<set_impl::symmetric_difference_policy, A, B, Comp>; };
+
+template <typename A, typename B, typename Comp = typename A::comp>
+using set_union_t = typename set_union<A, B, Comp>::type;
+
+template <typename A, typename B, typename Comp = typename A::comp>
+using set_intersection_t = typename set_intersection<A, B, Comp>::type;
+
+template <typename A, typename B, typename Comp = typename A::comp>
+using set_difference_t = typename set_difference<A, B, Comp>::type;
+
+template <typename A, typename B, typename Comp = typename A::comp>
+using set_symmetric_difference_t = typename set_symmetric_difference<A, B, Comp>::type;
+
+
+/// --- map, type key => type value, O(log n) --- ///
+
+/// Key-value pair stored in map nodes
+template <typename K, typename V>
+struct entry {
+    using key   = K;
+    using value = V;
+};
+
+namespace map_impl {
+    
+    template <typename T>
+    struct key_of { using type = T; };
+    
+    template <typename K, typename V>
+    struct key_of<entry<K, V>> { using type = K; };
+    
+    /// Orders entries (and bare keys, so map can be searched by key) by keys in terms of Comp
+    template <typename Comp>
+    struct key_comp : public eq_traits<key_comp<Comp>> {
+        template <typename U, typename V>
+        struct lt : std::integral_constant<bool,
+            Comp::template lt<typename key_of<U>::type, typename key_of<V>::type>::value> {};
+    };
+    
+    /// Replaces entry with the same key, path to it is copied, O(h)
+    template <typename Tree, typename E>
+    struct assign;
+    
+    template <typename T, typename L, typename R, typename C, typename E>
+    struct assign<node<T, L, R, C>, E> {
+    private:
+        enum : bool { is_equal  = C::template eq<E, T>::value };
+        enum : bool { is_less   = C::template lt<E, T>::value };
+        
+        struct left     { using type = node<T, typename assign<L, E>::type, R, C>; };
+        struct right    { using type = node<T, L, typename assign<R, E>::type, C>; };
+    public:
+        using type = eval_if_t<is_equal, identity<node<E, L, R, C>>, eval_if<is_less, left, right>>;
+    };
+    
+    /// Keys of sorted entries are distinct: every key is less than the next one, O(n) instantiations
+    template <typename Sorted, typename Comp, size_t N = std::tuple_size<Sorted>::value>
+    struct distinct : pairwise_less<key_comp<Comp>, tuple_take_t<Sorted, N - 1>, tuple_drop_t<Sorted, 1>> {};
+    
+    template <typename Sorted, typename Comp>
+    struct distinct<Sorted, Comp, 0> : std::true_type {};
+    
+    template <typename Entries, typename Comp>
+    struct build {
+    private:
+        using sorted = merge_sort_t<Entries, key_comp<Comp>>;
+        
+        static_assert(distinct<sorted, Comp>::value, LOG_HEAD "build_map requires unique keys");
+    public:
+        using type = build_balanced_t<sorted, key_comp<Comp>>;
+    };
+}
+
+/// Contains entry<K,V> with key equal to K, NIL if there is none, O(log n)
+template <typename Map, typename K>
+struct find;
+
+/// Contains value of key K (must exist), O(log n)
+template <typename Map, typename K>
+struct at;
+
+/// Replaces value of key K or inserts new entry (map stays balanced), O(log n)
+template <typename Map, typename K, typename V>
+struct insert_or_assign;
+
+/// Removes entry of key K (if any), map stays balanced, O(log n)
+template <typename Map, typename K>
+struct erase;
+
+/**
+ * Compile-time map: AVL tree of entry<K,V> ordered by keys (Comp compares keys), so lookup
+ * is O(log n) instantiations instead of linear type list scan. Keys must be unique.
+ *      using handlers = build_map_t<std::tuple<entry<msg_a, on_a>, entry<msg_b, on_b>>, type_comp>;
+ *      using handler  = at_t<handlers, msg_b>;
+ */
+template <typename Comp = sizeof_comp, typename Root = NIL>
+struct map {
+    using comp      = Comp;                     // keys comparator
+    using node_comp = map_impl::key_comp<Comp>; // entries comparator of nodes
+    using root      = Root;                     // AVL tree of entries or NIL
+    
+    template <typename K>
+    using find = typename tree::find<map, K>::type;
+    
+    template <typename K>
+    using at = typename tree::at<map, K>::type;
+    
+    template <typename K, typename V>
+    using insert_or_assign = typename tree::insert_or_assign<map, K, V>::type;
+    
+    template <typename K>
+    using erase = typename tree::erase<map, K>::type;
+};
+
+template <typename Comp, typename Root, typename K>
+struct find<map<Comp, Root>, K> {
+private:
+    using found = search_t<Root, K, map_impl::key_comp<Comp>>;
+    
+    struct entry_of { using type = typename found::type; };
+public:
+    using type = eval_if_t<std::is_same<found, NIL>::value, identity<NIL>, entry_of>;
+};
+
+template <typename Map, typename K>
+struct at {
+private:
+    using found = typename find<Map, K>::type;
+    static_assert(!std::is_same<found, NIL>::value, LOG_HEAD "map key not found");
+public:
+    using type = typename found::value;
+};
+
+template <typename Comp, typename Root, typename K, typename V>
+struct insert_or_assign<map<Comp, Root>, K, V> {
+private:
+    using C = map_impl::key_comp<Comp>;
+public:
+    using type = map<Comp, eval_if_t<
+        std::is_same<search_t<Root, K, C>, NIL>::value,
+        avl::insert<Root, entry<K, V>, C>,
+        map_impl::assign<Root, entry<K, V>>
+    >>;
+};
+
+template <typename Comp, typename Root, typename K>
+struct erase<map<Comp, Root>, K> { using type = map<Comp, avl::remove_t<Root, K>>; };
+
+/// Constructs balanced map from tuple of entries with unique keys (checked), O(n log n)
+template <typename Entries, typename Comp = sizeof_comp>
+using build_map_t = map<Comp, typename map_impl::build<Entries, Comp>::type>;
+
+template <typename Map, typename K>
+using find_t = typename find<Map, K>::type;
+
+template <typename Map, typename K>
+using at_t = typename at<Map, K>::type;
+
+template <typename Map, typename K, typename V>
+using insert_or_assign_t = typename insert_or_assign<Map, K, V>::type;
+
+template <typename Map, typename K>
+using erase_t = typename erase<Map, K>::type;
+
+template <typename Comp, typename Root>
+struct walk<map<Comp, Root>> { using type = walk_t<Root>; };
+
+template <typename Comp, typename Root>
+struct size<map<Comp, Root>> : size<Root> {};
+
 } // tree
 } // ct
 } // ax
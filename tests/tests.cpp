@@ -1,6 +1,8 @@
 #include <ax.hpp>
 
 #include <algorithm>
+#include <climits>
+#include <cstdio>
 #include <set>
 
 #include <ax.ct.hpp>
@@ -21,12 +23,81 @@ struct sizeofs_summator {
 template <typename Acc, typename T>
 struct concatenator { using type = ct::tuple_push_t<Acc, T>; };
 
+template <typename U, typename V>
+struct values_summator { using type = std::integral_constant<size_t, U::value + V::value>; };
+
+template <typename U, typename V>
+struct concat_op { using type = ct::tuple_concat_t<U, V>; };
+
+template <typename Seq>
+struct indices_tuple;
+
+template <size_t... I>
+struct indices_tuple<ct::index_sequence<I...>> {
+    using type = std::tuple<std::integral_constant<size_t, I>...>; };
+
+template <size_t N>
+using indices_tuple_t = typename indices_tuple<ct::make_index_sequence_t<N>>::type;
+
+struct half { constexpr static double value = 0.5; };
+
+/// Pairs of equal values of distinct types: integral_constant<I> and num_t<I>
+template <typename Seq>
+struct paired;
+
+template <size_t... I>
+struct paired<ct::index_sequence<I...>> {
+    using nums = std::tuple<ct::math::num_t<I>...>;
+    using type = ct::tuple_concat_t<std::tuple<std::integral_constant<size_t, I>, ct::math::num_t<I>>...>;
+    using swapped = ct::tuple_concat_t<std::tuple<ct::math::num_t<I>, std::integral_constant<size_t, I>>...>;
+};
+
+/// Sorted keys across 64-key merge batches: evens 2*I and odds 2*I+1, odds share evens at I = 63, 64, 65
+template <typename Evens, typename Odds>
+struct interleaved;
+
+template <size_t... I, size_t... J>
+struct interleaved<ct::index_sequence<I...>, ct::index_sequence<J...>> {
+    using evens = std::tuple<ct::math::num_t<2*I>...>;
+    using odds = std::tuple<ct::math::num_t<2*J + (J < 63 || J > 65)>...>;
+};
+
 struct array_holder { static constexpr const size_t values[] = {1,2,3}; };
 constexpr const size_t array_holder::values[];
 
+/// Remembers dispatched value
+struct value_catcher {
+    size_t& caught;
+    
+    template <typename T>
+    void operator()(ct::identity<T>) const { caught = T::value; }
+};
+
 struct str_func { constexpr static char const* str() { return "12345"; } };
 struct str_data { constexpr static auto str = str_func::str(); };
 
+/// Compares runtime searcher with std::string::find: pseudo-random haystacks over {a,b}, needle at the end
+template <typename S>
+void searcher_test() {
+    using ct::ctstr::searcher;
+    
+    const std::string needle = S::to_string();
+    unsigned long long seed = 0x2545F4914F6CDD1DULL;
+    
+    for(size_t n = 0; n < 300; ++n)
+        for(size_t round = 0; round < 4; ++round) {
+            std::string hay;
+            for(size_t i = 0; i < n; ++i) {
+                seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+                hay += ((seed >> 33) % 4 == 0) ? 'b' : 'a';
+            }
+            if(round == 0 && n >= needle.size())
+                hay.replace(n - needle.size(), needle.size(), needle);
+            
+            LIGHT_TEST(searcher<S>::find(hay.data(), hay.size()) == hay.find(needle));
+        }
+}
+
 void ct_test() {
     using namespace ct;
     
@@ -40,15 +111,66 @@ void ct_test() {
         
         static_assert(std::is_same<tuple_concat_t<t1,t2>, t3>::value, "");
         static_assert(std::is_same<tuple_push_t<t3,bool>, t4>::value, "");
+        
+        static_assert(std::is_same<tuple_concat_t<>, std::tuple<>>::value, "");
+        static_assert(std::is_same<tuple_concat_t<t1>, t1>::value, "");
+        static_assert(std::is_same<tuple_concat_t<t1,std::tuple<>,t2,std::tuple<bool>>, t4>::value, "");
+        static_assert(std::is_same<
+            tuple_concat_t<t1,t2,t1,t2,t1,t2,t1,t2,t1,t2,t1>,
+            tuple_concat_t<t3,t3,t3,t3,t3,t1>
+        >::value, "");
         static_assert(std::is_same<tuple_transform_t<t4,2,4>, t5>::value, "");
         static_assert(std::is_same<tuple_transform_t<t1,0,std::tuple_size<t1>::value, unsignifier>, t6>::value, "");
         
+        static_assert(std::is_same<tuple_transform_linear<t4,2,4>::type, t5>::value, "");
+        static_assert(std::is_same<tuple_transform_indexed<t4,2,4>::type, t5>::value, "");
+        static_assert(std::is_same<tuple_transform_t<t4,3,3>, std::tuple<>>::value, "");
+        static_assert(std::is_same<tuple_transform_t<t2,0,2,identity,t1>, t3>::value, "");
+        
+        static_assert(all_true<>::value && all_true<true, true>::value && !all_true<true, false, true>::value, "");
+        static_assert(!any_true<>::value && any_true<false, true>::value && !any_true<false, false>::value, "");
+        static_assert(pairwise_less<tree::sizeof_comp, std::tuple<char, short>, std::tuple<short, long long>>::value, "");
+        static_assert(!pairwise_less<tree::sizeof_comp, std::tuple<char, short>, std::tuple<short, short>>::value, "");
+        
+        static_assert(std::is_same<make_index_sequence_t<0>, index_sequence<>>::value, "");
+        static_assert(std::is_same<make_index_sequence_t<5>, index_sequence<0,1,2,3,4>>::value, "");
+        static_assert(std::is_same<tuple_at_t<t4,0>, char>::value, "");
+        static_assert(std::is_same<tuple_at_t<t4,5>, bool>::value, "");
+        static_assert(std::is_same<tuple_drop_t<t3,3>, t2>::value, "");
+        static_assert(std::is_same<tuple_drop_t<t3,5>, std::tuple<>>::value, "");
+        static_assert(std::is_same<tuple_take_t<t3,3>, t1>::value, "");
+        static_assert(std::is_same<tuple_take_t<t3,0>, std::tuple<>>::value, "");
+        
+        using big = indices_tuple_t<4000>;
+        static_assert(std::tuple_size<big>::value == 4000, "");
+        static_assert(std::is_same<tuple_at_t<big,3999>, std::integral_constant<size_t,3999>>::value, "");
+        static_assert(std::is_same<
+            tuple_transform_t<big,2000,2002>,
+            std::tuple<std::integral_constant<size_t,2000>, std::integral_constant<size_t,2001>>
+        >::value, "");
+        static_assert(std::is_same<tuple_transform_t<big,0,4000>, big>::value, "");
+        
         struct zeroacc { enum : size_t { value = 0 }; };
         using reduced = tuple_reduce_t<t1, sizeofs_summator, zeroacc>;
         static_assert(reduced::type::value == sizeof(char) + sizeof(int) + sizeof(long), "");
         
         using concatenated = tuple_reduce_t<t2, concatenator, t1>;
         static_assert(std::is_same<concatenated, t3>::value, "");
+        
+        using small = indices_tuple_t<19>;
+        static_assert(std::is_same<tuple_reduce_t<small, concatenator>, small>::value, "");
+        static_assert(std::is_same<tuple_reduce_t<t2, concatenator, t1>, t3>::value, "");
+        
+        using sum = std::integral_constant<size_t, 2000*1999/2>;
+        using nums = indices_tuple_t<2000>;
+        static_assert(tuple_reduce_t<nums, values_summator, std::integral_constant<size_t,0>>::value == sum::value, "");
+        static_assert(tuple_reduce_tree_t<nums, values_summator>::value == sum::value, "");
+        static_assert(tuple_reduce_tree_t<nums, values_summator, std::integral_constant<size_t,1>>::value == sum::value + 1, "");
+        static_assert(std::is_same<tuple_reduce_tree_t<std::tuple<>, values_summator, zeroacc>, zeroacc>::value, "");
+        
+        using lists = std::tuple<std::tuple<char>, std::tuple<int, long>, std::tuple<>, t2>;
+        static_assert(std::is_same<tuple_reduce_tree_t<lists, concat_op>, t3>::value, "");
+        static_assert(std::is_same<tuple_reduce_tree_t<lists, concat_op, std::tuple<>>, t3>::value, "");
     }
     
     {
@@ -73,6 +195,27 @@ void ct_test() {
         static_assert(count_substr(str1, pat2) == 0, "");
         static_assert(count_substr(str1, pat3) == 2, "");
         static_assert(count_substr(str1, pat4) == 4, "");
+        static_assert(find_substr(str1, pat1, 2) == 3 && find_substr(str1, pat1, 4) == npos, "");
+        static_assert(find_substr(str1, "") == 0 && count_substr(str1, "") == 0, "");
+        static_assert(count_substr("aaaaa", "aa") == 2 && count_substr("abababab", "abab") == 2, "");
+        
+        // Two-Way search against naive one: all haystacks of length <= 7 and needles of length <= 3 over {a,b}
+        for(size_t hn = 0; hn <= 7; ++hn)
+            for(size_t hmask = 0; hmask < (1u << hn); ++hmask)
+                for(size_t sn = 1; sn <= 3; ++sn)
+                    for(size_t smask = 0; smask < (1u << sn); ++smask) {
+                        std::string h, s;
+                        for(size_t i = 0; i < hn; ++i) h += char('a' + ((hmask >> i) & 1));
+                        for(size_t i = 0; i < sn; ++i) s += char('a' + ((smask >> i) & 1));
+                        
+                        size_t count = 0;
+                        for(size_t p = h.find(s); p != std::string::npos; p = h.find(s, p + sn))
+                            ++count;
+                        
+                        LIGHT_TEST(find_substr(h.c_str(), s.c_str()) == h.find(s));
+                        LIGHT_TEST(find_substr(h.c_str(), s.c_str(), 1) == h.find(s, 1));
+                        LIGHT_TEST(count_substr(h.c_str(), s.c_str()) == count);
+                    }
         
         #define str2 "abc*|d"
         
@@ -103,6 +246,31 @@ void ct_test() {
         
         static_assert(eq<str,unpacked>::value, "");
         
+        // Printed texts are static arrays computed at compile time
+        using minus = value_text<std::integral_constant<int, -42>>;
+        using lowest = value_text<std::integral_constant<long long, LLONG_MIN>>;
+        using letter = value_text<std::integral_constant<char, 'x'>>;
+        enum class signed_enum : short { value = -7 };
+        
+        static_assert(minus::length == 3 && equal(minus::str(), "-42"), "");
+        static_assert(equal(lowest::str(), "-9223372036854775808"), "");
+        static_assert(equal(letter::str(), "x") && equal(value_text<std::true_type>::str(), "1"), "");
+        static_assert(equal(value_text<std::integral_constant<signed_enum, signed_enum::value>>::str(), "-7"), "");
+        static_assert(equal(value_text<std::integral_constant<unsigned, 0>>::str(), "0"), "");
+        
+        using values = std::tuple<std::integral_constant<int, 1>, std::integral_constant<long, -20>,
+                                  std::integral_constant<char, 'x'>, std::integral_constant<unsigned, 300>>;
+        
+        static_assert(tuple_printer<values>::length == 11 && equal(tuple_printer<values>::str(), "1,-20,x,300"), "");
+        static_assert(equal(tuple_printer<std::tuple<>>::str(), "") && equal(tuple_printer<indices_tuple_t<3>>::str(), "0,1,2"), "");
+        static_assert(equal(tuple_printer<packed>::str(), "97,98,99,42,124,100,0"), "");
+        LIGHT_TEST(tuple_printer<values>::print() == "1,-20,x,300");
+        
+        // Floating point values are streamed at runtime
+        using mixed = std::tuple<half, std::integral_constant<int, 3>, half>;
+        LIGHT_TEST(tuple_printer<mixed>::print() == "0.5,3,0.5");
+        LIGHT_TEST(tuple_printer<std::tuple<half>>::print() == "0.5");
+        
         #undef str2
         
         static_assert(strlen(str_func::str()) == 5, "");
@@ -115,6 +283,272 @@ void ct_test() {
         using string_from_data = string<literal_from_data>;
         
         static_assert(eq<string_from_func, string_from_data>::value, "");
+        
+        // Long literals: conversions have logarithmic depth
+        #define x10(s) s s s s s s s s s s
+        #define long_str x10(x10(x10("0123456789"))) "!"
+        
+        DEFINE_LITERAL(long_literal, long_str);
+        
+        using long_string = string<long_literal>;
+        
+        static_assert(strlen(long_str) == 10001 && long_string::length == 10001, "");
+        static_assert(std::tuple_size<string_to_tuple_t<long_string>>::value == 10002, "");
+        static_assert(eq<long_string, tuple_to_string_t<string_to_tuple_t<long_string>>>::value, "");
+        static_assert(eq<concat_t<long_string::substr_t<0, 5000>, long_string::substr_t<5000, 10001>>, long_string>::value, "");
+        static_assert(concat_t<long_string, long_string>::length == 20002, "");
+        static_assert(concat_t<long_string, long_string>::at(10001) == '0', "");
+        
+        static_assert(compare(long_str, long_str) == 0 && equal(long_str, long_str), "");
+        static_assert(compare(long_str, x10(x10(x10("0123456789")))) > 0, "");
+        static_assert(compare(x10("0123456789") "0", x10("0123456789") "1") < 0, "");
+        static_assert(compare("", "a") < 0 && compare("b", "a") > 0 && !equal("ab", "abc"), "");
+        static_assert(compare("\xff", "a") > 0, "");
+        
+        // Search in long literals has logarithmic depth
+        DEFINE_LITERAL(tail_literal, "9!");
+        DEFINE_LITERAL(period_literal, "0123");
+        
+        static_assert(find_substr(long_str, "9!") == 9999 && find_substr(long_str, "90") == 9, "");
+        static_assert(count_substr(long_str, "0123") == 1000, "");
+        static_assert(find_all<long_literal, tail_literal>::size == 1, "");
+        static_assert(find_all<long_literal, period_literal>::size == 1000, "");
+        static_assert(find_all<long_literal, period_literal>::values[999] == 9990, "");
+        
+        DEFINE_LITERAL(overlapped, "aaaa");
+        DEFINE_LITERAL(twice, "aa");
+        using all = find_all<overlapped, twice>;
+        
+        static_assert(all::size == 3 && all::values[0] == 0 && all::values[2] == 2 && all::values[3] == npos, "");
+        static_assert(find_all<twice, overlapped>::size == 0 && find_all<string<literal>, string<literal>>::size == 1, "");
+        
+        // Runtime search: filter characters are the rarest ones
+        DEFINE_LITERAL(rare_literal, "aaa=aaaZ");
+        DEFINE_LITERAL(unrolled_literal, x10("aaaaaaab") "ab");
+        
+        using rare_searcher = searcher<string<rare_literal>>;
+        
+        static_assert(rare_searcher::rare == 7 && rare_searcher::second == 3, "");
+        static_assert(searcher<string<twice>>::rare == 0 && searcher<string<twice>>::second == 1, "");
+        
+        LIGHT_TEST(searcher<long_string>::find(long_str, long_string::length) == 0);
+        LIGHT_TEST(searcher<string<tail_literal>>::find(long_str, long_string::length) == 9999);
+        LIGHT_TEST(searcher<string<period_literal>>::find(long_str + 1, long_string::length - 1) == 9);
+        LIGHT_TEST(searcher<string<literal>>::find(long_str, long_string::length) == npos);
+        LIGHT_TEST(searcher<sub>::find(str::str(), str::length) == 1);
+        using empty = str::substr_t<0, 0>;
+        LIGHT_TEST(searcher<empty>::find(str::str(), 0) == 0);
+        
+        searcher_test<string<twice>>();
+        searcher_test<str::substr_t<0, 1>>();
+        searcher_test<string<overlapped>>();
+        searcher_test<concat_t<string<overlapped>, str::substr_t<0, 2>>>();
+        searcher_test<string<unrolled_literal>>();
+        
+        // Perfect hash: ids are indices in key list, lookup costs one hash and one comparison
+        DEFINE_LITERAL(kw_if, "if");
+        DEFINE_LITERAL(kw_else, "else");
+        DEFINE_LITERAL(kw_for, "for");
+        DEFINE_LITERAL(kw_while, "while");
+        DEFINE_LITERAL(kw_return, "return");
+        DEFINE_LITERAL(kw_constexpr, "constexpr");
+        DEFINE_LITERAL(kw_static_assert, "static_assert");
+        DEFINE_LITERAL(kw_empty, "");
+        
+        using keywords = perfect_hash<string<kw_if>, string<kw_else>, string<kw_for>, string<kw_while>, string<kw_return>,
+            string<kw_constexpr>, string<kw_static_assert>, string<kw_empty>, long_string, conc, string<twice>>;
+        
+        static_assert(keywords::size == 11, "");
+        static_assert(keywords::lookup("if") == 0 && keywords::lookup("static_assert") == 6, "");
+        static_assert(keywords::lookup("") == 7 && keywords::lookup(long_str) == 8 && keywords::lookup("abc*|dbc*|d") == 9, "");
+        static_assert(keywords::lookup("i") == npos && keywords::lookup("iff") == npos && keywords::lookup("a") == npos, "");
+        
+        const std::string keys[] = {"if", "else", "for", "while", "return", "constexpr", "static_assert", "", long_str, conc::to_string(), "aa"};
+        for(size_t id = 0; id < keywords::size; ++id) {
+            const std::string key = keys[id];
+            LIGHT_TEST(keywords::lookup(key) == id);
+            LIGHT_TEST(keywords::lookup(key + "_") == npos);
+            LIGHT_TEST(key.empty() || keywords::lookup(key.data(), key.size() - 1) == npos);
+        }
+        
+        // Runtime hash is bit-identical to constexpr one for every key length
+        for(size_t n = 0; n <= 40; ++n)
+            LIGHT_TEST(perfect_hash_impl::key_hash(long_str + 3, n) == perfect_hash_impl::runtime_hash(long_str + 3, n));
+        
+        using single = perfect_hash<string<kw_for>>;
+        static_assert(single::lookup("for") == 0 && single::lookup("fo") == npos, "");
+        LIGHT_TEST(single::lookup(std::string("for")) == 0 && single::lookup(std::string("if")) == npos);
+        
+        // String hashes: reference values, runtime versions are bit-identical for every length
+        static_assert(fnv1a::hash("") == 0xcbf29ce484222325ULL && fnv1a::hash("a") == 0xaf63dc4c8601ec8cULL, "");
+        static_assert(fnv1a::hash("foobar") == 0x85944171f73967e8ULL, "");
+        static_assert(xxhash64::hash("") == 0xef46db3751d8e999ULL && xxhash64::hash("a") == 0xd24ec4f1a98c6e5bULL, "");
+        static_assert(xxhash64::hash("abc") == 0x44bc2cf5ad770999ULL, "");
+        static_assert(xxhash64::hash("Nobody inspects the spammish repetition") == 0xfbcea83c8a378bf1ULL, "");
+        static_assert(crc32c::hash("") == 0 && crc32c::hash("123456789") == 0xe3069283u, "");
+        static_assert(hash_of<crc32c, string<kw_while>>::value == crc32c::hash("while"), "");
+        
+        for(size_t n = 0; n <= 100; ++n) {
+            LIGHT_TEST(fnv1a::hash(long_str + 3, n) == fnv1a::runtime_hash(long_str + 3, n));
+            LIGHT_TEST(xxhash64::hash(long_str + 3, n) == xxhash64::runtime_hash(long_str + 3, n));
+            LIGHT_TEST(xxhash64::hash(long_str + 3, n, 42) == xxhash64::runtime_hash(long_str + 3, n, 42));
+            LIGHT_TEST(crc32c::hash(long_str + 3, n) == crc32c::runtime_hash(long_str + 3, n));
+        }
+        
+        constexpr fnv1a::value_type long_fnv1a = fnv1a::hash(long_str);
+        constexpr xxhash64::value_type long_xxhash64 = xxhash64::hash(long_str);
+        constexpr crc32c::value_type long_crc32c = crc32c::hash(long_str);
+        LIGHT_TEST(long_fnv1a == fnv1a::runtime_hash(long_str) && long_xxhash64 == xxhash64::runtime_hash(long_str));
+        LIGHT_TEST(long_crc32c == crc32c::runtime_hash(long_str));
+        
+        constexpr xxhash64::value_type bytes_xxhash64 = xxhash64::hash("\xe2\x82\xac\xff\x80\x01");
+        constexpr crc32c::value_type bytes_crc32c = crc32c::hash("\xe2\x82\xac\xff\x80\x01");
+        LIGHT_TEST(bytes_xxhash64 == xxhash64::runtime_hash("\xe2\x82\xac\xff\x80\x01", 6));
+        LIGHT_TEST(bytes_crc32c == crc32c::runtime_hash("\xe2\x82\xac\xff\x80\x01", 6));
+        
+        // String switch: one hash and one comparison, colliding case sets are rejected at compile time
+        static_assert(unique_hashes<crc32c, string<kw_if>, string<kw_else>, long_string>::value, "");
+        static_assert(!unique_hashes<fnv1a, string<kw_if>, string<kw_else>, string<kw_if>>::value, "");
+        static_assert(string_hash_impl::one_of<string<kw_else>, string<kw_if>, string<kw_else>>::value, "");
+        static_assert(!string_hash_impl::one_of<string<kw_for>, string<kw_if>, string<kw_else>>::value, "");
+        
+        using commands = string_switch<fnv1a, string<kw_if>, string<kw_else>, string<kw_for>, string<kw_empty>>;
+        auto dispatch = [](std::string const& key) -> int {
+            switch(commands::hash(key)) {
+                case commands::label<string<kw_if>>():      return commands::is<string<kw_if>>(key) ? 1 : 0;
+                case commands::label<string<kw_else>>():    return commands::is<string<kw_else>>(key) ? 2 : 0;
+                case commands::label<string<kw_for>>():     return commands::is<string<kw_for>>(key) ? 3 : 0;
+                case commands::label<string<kw_empty>>():   return commands::is<string<kw_empty>>(key) ? 4 : 0;
+                default:                                    return 0;
+            }
+        };
+        LIGHT_TEST(dispatch("if") == 1 && dispatch("else") == 2 && dispatch("for") == 3 && dispatch("") == 4);
+        LIGHT_TEST(dispatch("iff") == 0 && dispatch("while") == 0 && dispatch("fo") == 0);
+        
+        // Multi-pattern search: one table lookup per byte, occurrences are the ones of find_all for every pattern
+        DEFINE_LITERAL(pat_he, "he");
+        DEFINE_LITERAL(pat_she, "she");
+        DEFINE_LITERAL(pat_his, "his");
+        DEFINE_LITERAL(pat_hers, "hers");
+        
+        using dictionary = aho_corasick<std::tuple<string<pat_he>, string<pat_she>, string<pat_his>, string<pat_hers>,
+            string<overlapped>, string<twice>, string<kw_static_assert>>>;
+        
+        static_assert(dictionary::size == 7 && dictionary::states == 26 && dictionary::classes == 10, "");
+        static_assert(aho_corasick<std::tuple<string<tail_literal>>>::states == 3, "");
+        
+        const std::string dictionary_keys[] = {"he", "she", "his", "hers", "aaaa", "aa", "static_assert"};
+        const std::string text = std::string("ushers said: hishe aaaaa hehers, static_asserts") + long_str;
+        
+        std::set<std::pair<size_t, size_t>> found, expected;
+        size_t last_end = 0;
+        bool ordered = true;
+        const size_t reported = dictionary::scan(text, [&](size_t id, size_t offset) {
+            ordered = ordered && offset + dictionary_keys[id].size() >= last_end;
+            last_end = offset + dictionary_keys[id].size();
+            found.insert(std::make_pair(offset, id));
+        });
+        for(size_t id = 0; id < dictionary::size; ++id)
+            for(size_t pos = text.find(dictionary_keys[id]); pos != std::string::npos; pos = text.find(dictionary_keys[id], pos + 1))
+                expected.insert(std::make_pair(pos, id));
+        
+        LIGHT_TEST(ordered && reported == found.size() && found == expected && expected.size() == 16);
+        LIGHT_TEST(dictionary::scan("", 0, [](size_t, size_t) {}) == 0);
+        
+        // Formats compiled at compile time: output matches snprintf, worst-case size is a constant
+        DEFINE_LITERAL(record_format, "id=%u ts=%08llx %% sym=%.4s side=%c qty=%6d|%hhd|%zu|%X%%");
+        DEFINE_LITERAL(plain_format, "plain %% text");
+        
+        using record = format<string<record_format>>;
+        using plain = format<string<plain_format>>;
+        
+        static_assert(record::arity == 8 && std::tuple_size<record::elements>::value == 18, "");
+        static_assert(record::max_size == 29 + 10 + 16 + 4 + 1 + 11 + 4 + 20 + 8, "");
+        static_assert(plain::arity == 0 && plain::max_size == 12, "");
+        static_assert(record::accepts<unsigned, unsigned long long, char const*, char, int, signed char, size_t, unsigned short>::value, "");
+        static_assert(record::accepts<unsigned char, unsigned, char[3], signed char, short, signed char, unsigned, unsigned>::value, "");
+        static_assert(!record::accepts<int, unsigned long long, char const*, char, int, signed char, size_t, unsigned>::value, "");
+        static_assert(!record::accepts<unsigned, unsigned long long, char const*, char, long long, signed char, size_t, unsigned>::value, "");
+        static_assert(!record::accepts<unsigned, unsigned long long, char const*, char, int>::value, "");
+        
+        const int quantities[] = {0, 7, -17, 123456, -1234567, INT_MAX, INT_MIN};
+        const std::string symbols[] = {"", "AB", "AAPL", "GOOGL"};
+        for(size_t i = 0; i < 7; ++i)
+            for(size_t j = 0; j < 4; ++j) {
+                char actual[record::max_size], expected[record::max_size + 1];
+                const unsigned long long ts = 0x1234567ULL << (9 * i);
+                const signed char small = static_cast<signed char>(-128 + 40 * int(i));
+                const size_t written = record::write(actual, unsigned(i * 1000003), ts, symbols[j], char('a' + j), quantities[i], small, size_t(-1) >> i, 0xBEEFu << i);
+                const int length = std::snprintf(expected, sizeof(expected), "id=%u ts=%08llx %% sym=%.4s side=%c qty=%6d|%hhd|%zu|%X%%",
+                    unsigned(i * 1000003), ts, symbols[j].c_str(), char('a' + j), quantities[i], small, size_t(-1) >> i, 0xBEEFu << i);
+                LIGHT_TEST(written == size_t(length) && std::string(actual, written) == expected);
+            }
+        
+        char plain_text[plain::max_size];
+        LIGHT_TEST(std::string(plain_text, plain::write(plain_text)) == "plain % text");
+        
+        // Patterns compiled at compile time: fields are decoded into tuple, tokens point into the text
+        DEFINE_LITERAL(quote_pattern, "id=%u ts=%llu sym=%s px=%d,%hhd|%x|%4u%2c%c%%");
+        
+        using quote = scanner<string<quote_pattern>>;
+        using quote_values = std::tuple<unsigned, unsigned long long, token, int, signed char, unsigned, unsigned, token, char>;
+        
+        static_assert(std::is_same<quote::values, quote_values>::value && quote::arity == 9, "");
+        static_assert(std::tuple_size<quote::elements>::value == 17, "");
+        
+        const std::string quote_line = "id=4294967295 ts=18446744073709551615 sym=AAPL px=-2147483648,-128|DeadBeef|123456z% tail";
+        quote::values fields;
+        
+        LIGHT_TEST(quote::scan(quote_line, fields) == quote_line.size() - 5);
+        LIGHT_TEST(std::get<0>(fields) == 4294967295u && std::get<1>(fields) == 18446744073709551615ull && std::get<2>(fields).to_string() == "AAPL");
+        LIGHT_TEST(std::get<3>(fields) == INT_MIN && std::get<4>(fields) == -128 && std::get<5>(fields) == 0xDEADBEEFu);
+        LIGHT_TEST(std::get<6>(fields) == 1234 && std::get<7>(fields).to_string() == "56" && std::get<8>(fields) == 'z');
+        
+        const std::string mismatches[] = {
+            "id=4294967296 ts=1 sym=A px=1,1|1|1234567%",     // out of unsigned
+            "id=1 ts=18446744073709551616 sym=A px=1,1|1|1234567%",
+            "id=1 ts=1 sym=A px=2147483648,1|1|1234567%",
+            "id=1 ts=1 sym=A px=1,128|1|1234567%",
+            "id=1 ts=1 sym= px=1,1|1|1234567%",             // empty token
+            "id=1 ts=1 sym=A  px=1,1|1|1234567%",           // literals match exactly
+            "id=1 ts=1 sym=A px=1,1|1|123456",              // truncated
+            "id=+1 ts=1 sym=A px=1,1|1|1234567%"
+        };
+        for(auto& line : mismatches)
+            LIGHT_TEST(quote::scan(line, fields) == npos);
+        
+        // Integers against sscanf: lengths around 8-digit steps
+        DEFINE_LITERAL(number_pattern, "%lld;%llu");
+        using numbers = scanner<string<number_pattern>>;
+        for(long long x = 1, sign = 1; x > 0 && x < LLONG_MAX / 3; x = x * 3 + 1, sign = -sign) {
+            char line[64];
+            const int length = std::snprintf(line, sizeof(line), "%lld;%llu", sign * x, 18446744073709551615ull / (unsigned long long)x);
+            long long expected_signed = 0;
+            unsigned long long expected_unsigned = 0;
+            std::sscanf(line, "%lld;%llu", &expected_signed, &expected_unsigned);
+            numbers::values parsed;
+            LIGHT_TEST(numbers::scan(line, size_t(length), parsed) == size_t(length) &&
+                std::get<0>(parsed) == expected_signed && std::get<1>(parsed) == expected_unsigned);
+        }
+        
+        // Zero-padded fields: leading zeros don't count against the digits of the type
+        DEFINE_LITERAL(padded_pattern, "%u|%hhu|%d|%llu|%3u");
+        using padded = scanner<string<padded_pattern>>;
+        padded::values widths;
+        const std::string padded_line = "02507869910|0001|-000000000000000000042|000000000000000000000018446744073709551615|0007";
+        LIGHT_TEST(padded::scan(padded_line, widths) == padded_line.size() - 1);
+        LIGHT_TEST(std::get<0>(widths) == 2507869910u && std::get<1>(widths) == 1 && std::get<2>(widths) == -42);
+        LIGHT_TEST(std::get<3>(widths) == 18446744073709551615ull && std::get<4>(widths) == 0);
+        LIGHT_TEST(padded::scan("00|000256|0|0|0", widths) == npos);
+        LIGHT_TEST(padded::scan("0000|0|0|0|000", widths) == 14 && std::get<0>(widths) == 0);
+
+        // Results are backed by single array, without character types
+        static_assert(std::is_same<concat_t<str, sub>, string<indexed_literal<concat<str, sub>::source>>>::value, "");
+        static_assert(eq<conc, concat_t<str::substr_t<0, 3>, concat_t<str::substr_t<3, 6>, sub>>>::value, "");
+        static_assert(!eq<conc, str>::value && !eq<str::substr_t<0, 5>, str>::value, "");
+
+        #undef long_str
+        #undef x10
     }
     
     {
@@ -283,6 +717,11 @@ void ct_test() {
         
         static_assert(std::is_same<typename search<t1, num_t<7>, num_comp>::tree, t1>::value, "");
         
+        // lazy search: subtrees below found node are never compared (void has no ::value)
+        using lazy = node<num_t<5>, leaf<void, num_comp>, leaf<void, num_comp>, num_comp>;
+        static_assert(std::is_same<search_t<lazy, num_t<5>>, lazy>::value, "");
+        static_assert(std::is_same<remove_t<node<num_t<5>, lazy, NIL, num_comp>, num_t<5>>, lazy>::value, "");
+        
         static_assert(std::is_same<parent_of_t<t1, t1    >, NIL   >::value, "");
         static_assert(std::is_same<parent_of_t<t1, found2>, NIL   >::value, "");
         static_assert(std::is_same<parent_of_t<t1, found5>, found6>::value, "");
@@ -301,6 +740,45 @@ void ct_test() {
         // Debug representation
         stdcout(print<t5, value_printer>::str());
         
+        using p5 = print<t5, value_printer>;
+        using p4 = print<t4, value_printer>;
+        using p4_sizes = print<t4, sizeof_printer>;
+        using p_nil = print<NIL, value_printer>;
+        using p_long = print<leaf<num_t<123456>, num_comp>, value_printer>;
+        
+        LIGHT_TEST(p5::str() ==
+            "                  /--{2}   \n"
+            "         /--{3}--<\n"
+            "                  \\--{4}   \n"
+            "--{5}---<\n"
+            "         \\--{7}--\\\n"
+            "                  \\--{8}   ");
+        LIGHT_TEST(p4_sizes::str(print_format::json) ==
+            "{\"value\":\"1\",\"left\":{\"value\":\"1\",\"left\":null,\"right\":null},"
+            "\"right\":{\"value\":\"1\",\"left\":null,\"right\":null}}");
+        LIGHT_TEST(p4::str(print_format::dot) ==
+            "digraph tree {\n"
+            "    n0 [label=\"5\"];\n"
+            "    n0 -> n1 [tailport=sw];\n"
+            "    n1 [label=\"3\"];\n"
+            "    n0 -> n2 [tailport=se];\n"
+            "    n2 [label=\"7\"];\n"
+            "}\n");
+        LIGHT_TEST(p_nil::str().empty());
+        LIGHT_TEST(p_nil::str(print_format::json) == "null");
+        
+        // Control characters of labels are escaped
+        using p_tab = print<leaf<std::integral_constant<char, '\t'>>, value_printer>;
+        using p_nul = print<leaf<std::integral_constant<char, '\0'>>, value_printer>;
+        LIGHT_TEST(p_tab::str(print_format::json) == "{\"value\":\"\\u0009\",\"left\":null,\"right\":null}");
+        LIGHT_TEST(p_nul::str(print_format::json) == "{\"value\":\"\\u0000\",\"left\":null,\"right\":null}");
+        
+        // Fixed buffer: output is truncated and null-terminated; long values are cut to the floor length
+        char buffer[16];
+        LIGHT_TEST(p4::write(buffer, sizeof(buffer)) == 15);
+        LIGHT_TEST(p4::str().compare(0, 15, buffer) == 0);
+        LIGHT_TEST(p_long::str() == "--{12345 ");
+
         static_assert(!std::is_same<t5, t1>::value, ""); // cause of different initial comparators
         static_assert( tree_eq<t1,t1>::value, ""); // inner type-by-type comparing
         static_assert(!tree_eq<t1,t2>::value, "");
@@ -370,6 +848,319 @@ void ct_test() {
         using rem6 = t7::erase<num_t<2>>;
         static_assert(rem6::height<>::value == 3, "");
         stdcout(rem6::stringify<value_printer>::str());
+        
+        {
+            /// AVL: sorted keys produce balanced tree instead of list
+            using sorted = std::tuple<
+                num_t<1>, num_t<2>, num_t<3>, num_t<4>, num_t<5>, num_t<6>, num_t<7>, num_t<8>,
+                num_t<9>, num_t<10>, num_t<11>, num_t<12>, num_t<13>, num_t<14>, num_t<15>>;
+            
+            using plain    = insert_tuple_t<NIL, sorted, num_comp>;
+            using balanced = avl::insert_tuple_t<NIL, sorted, num_comp>;
+            
+            static_assert(height<plain>::value == 15, "");
+            static_assert(height<balanced>::value == 4, "");
+            static_assert(avl::is_balanced<balanced>::value, "");
+            static_assert(!avl::is_balanced<plain>::value, "");
+            static_assert(std::is_same<walk_t<balanced>, sorted>::value, "");
+            static_assert(array_eq(tuple_to_array_t<level_walk_t<balanced>>::values,
+                {8UL,4UL,12UL,2UL,6UL,10UL,14UL,1UL,3UL,5UL,7UL,9UL,11UL,13UL,15UL}), "");
+            
+            static_assert(std::is_same<search_t<balanced, num_t<11>>::type, num_t<11>>::value, "");
+            
+            // left-right and right-left rotations
+            using lr = avl::insert_tuple_t<NIL, std::tuple<num_t<3>,num_t<1>,num_t<2>>, num_comp>;
+            using rl = avl::insert_tuple_t<NIL, std::tuple<num_t<1>,num_t<3>,num_t<2>>, num_comp>;
+            static_assert(std::is_same<lr, rl>::value, "");
+            static_assert(lr::type::value == 2 && height<lr>::value == 2, "");
+            
+            using removed = avl::remove_tuple_t<balanced, std::tuple<
+                num_t<1>, num_t<2>, num_t<3>, num_t<4>, num_t<5>, num_t<8>, num_t<6>, num_t<99>>>;
+            static_assert(avl::is_balanced<removed>::value, "");
+            static_assert(array_eq(tuple_to_array_t<walk_t<removed>>::values,
+                {7UL,9UL,10UL,11UL,12UL,13UL,14UL,15UL}), "");
+            static_assert(height<removed>::value == 4, "");
+            
+            static_assert(std::is_same<avl::remove_tuple_t<lr, std::tuple<num_t<1>,num_t<2>,num_t<3>>>, NIL>::value, "");
+            
+            stdcout(print<removed, value_printer>::str());
+        }
+        
+        {
+            /// Bulk construction
+            using sorted = std::tuple<
+                num_t<1>, num_t<2>, num_t<3>, num_t<4>, num_t<5>, num_t<6>, num_t<7>, num_t<8>,
+                num_t<9>, num_t<10>, num_t<11>, num_t<12>, num_t<13>, num_t<14>, num_t<15>>;
+            using shuffled = std::tuple<
+                num_t<9>, num_t<2>, num_t<14>, num_t<7>, num_t<1>, num_t<12>, num_t<5>, num_t<15>,
+                num_t<3>, num_t<10>, num_t<8>, num_t<13>, num_t<4>, num_t<11>, num_t<6>>;
+            
+            using built = build_balanced_t<sorted, num_comp>;
+            static_assert(std::is_same<built, avl::insert_tuple_t<NIL, sorted, num_comp>>::value, "");
+            static_assert(std::is_same<build_balanced_t<std::tuple<>, num_comp>, NIL>::value, "");
+            static_assert(height<build_balanced_t<tuple_take_t<sorted, 8>, num_comp>>::value == 4, "");
+            
+            static_assert(std::is_same<merge_sort_t<shuffled, num_comp>, sorted>::value, "");
+            static_assert(std::is_same<merge_sort_t<std::tuple<>, num_comp>, std::tuple<>>::value, "");
+            static_assert(std::is_same<build_t<shuffled, num_comp>, built>::value, "");
+            
+            // stability: same-sized types keep their order
+            using mixed = std::tuple<double, int, char, long, float, short, unsigned char>;
+            static_assert(std::is_same<
+                merge_sort_t<mixed, sizeof_comp>,
+                std::tuple<char, unsigned char, short, int, float, double, long>
+            >::value, "");
+            static_assert(std::is_same<
+                merge_sorted_t<std::tuple<char, int, int>, std::tuple<unsigned char, float, double>, sizeof_comp>,
+                std::tuple<char, unsigned char, int, int, float, double>
+            >::value, "");
+            
+            // long operands are split at the middle of the longer one, equal types of the first go first
+            using firsts = indices_tuple_t<150>;
+            using pairs = paired<make_index_sequence_t<100>>;
+            static_assert(std::is_same<merge_sorted_t<firsts, pairs::nums, num_comp>,
+                tuple_concat_t<pairs::type, tuple_drop_t<firsts, 100>>>::value, "");
+            static_assert(std::is_same<merge_sorted_t<pairs::nums, firsts, num_comp>,
+                tuple_concat_t<pairs::swapped, tuple_drop_t<firsts, 100>>>::value, "");
+            
+            /// Eytzinger export: complete tree => level order, any other shape is relaid out
+            using eyt1 = eytzinger_t<built>;
+            static_assert(array_eq(eyt1::values, tuple_to_array_t<level_walk_t<built>>::values), "");
+            
+            using eyt2 = eytzinger_t<t1>;
+            static_assert(array_eq(eyt2::values, {5UL,3UL,8UL,2UL,4UL,7UL}), "");
+            static_assert(eyt2::rank(0) == 3 && eyt2::rank(2) == 5 && eyt2::rank(3) == 0, "");
+            
+            auto const& vals = tuple_to_array_t<walk_t<t1>>::values;
+            for(size_t key = 0; key < 10; ++key) {
+                size_t i = eyt2::lower_bound(key);
+                size_t expected = std::lower_bound(std::begin(vals), std::end(vals), key) - std::begin(vals);
+                LIGHT_TEST((i == eyt2::size ? eyt2::size : eyt2::rank(i)) == expected);
+            }
+            for(size_t key = 0; key < 17; ++key) {
+                size_t i = eyt1::lower_bound(key);
+                LIGHT_TEST(i == eyt1::size ? key > 15 : eyt1::values[i] == std::max<size_t>(key, 1));
+            }
+            
+            /// Dispatch: comparison tree (t1) and jump table (built, contiguous keys)
+            size_t caught = 0;
+            for(size_t key = 0; key < 17; ++key) {
+                caught = 0;
+                LIGHT_TEST(dispatch<built>(key, value_catcher{caught}) == (key >= 1 && key <= 15));
+                LIGHT_TEST(caught == (key <= 15 ? key : 0));
+                
+                caught = 0;
+                bool found = std::binary_search(std::begin(vals), std::end(vals), key);
+                LIGHT_TEST(dispatch<t1>(key, value_catcher{caught}) == found);
+                LIGHT_TEST(caught == (found ? key : 0));
+            }
+            LIGHT_TEST(!dispatch<NIL>(5, value_catcher{caught}));
+            LIGHT_TEST(dispatch<leaf<num_t<5>>>(5, value_catcher{caught}) && caught == 5);
+            
+            // Walk of type_comp tree is not ordered by value: dispatch sorts it
+            using hashed_dense = build_t<std::tuple<num_t<4>, num_t<1>, num_t<3>, num_t<2>, num_t<5>>, type_comp>;
+            using hashed_sparse = build_t<std::tuple<num_t<40>, num_t<10>, num_t<30>, num_t<20>, num_t<50>>, type_comp>;
+            for(size_t key = 0; key < 60; ++key) {
+                caught = 0;
+                LIGHT_TEST(dispatch<hashed_dense>(key, value_catcher{caught}) == (key >= 1 && key <= 5));
+                LIGHT_TEST(caught == (key >= 1 && key <= 5 ? key : 0));
+                
+                caught = 0;
+                bool found = key % 10 == 0 && key >= 10 && key <= 50;
+                LIGHT_TEST(dispatch<hashed_sparse>(key, value_catcher{caught}) == found);
+                LIGHT_TEST(caught == (found ? key : 0));
+            }
+        }
+        
+        {
+            /// B-tree
+            using b0 = btree<2, num_comp>;
+            using b3 = insert_tuple_t<b0, std::tuple<num_t<1>, num_t<2>, num_t<3>>>;
+            static_assert(std::is_same<b3::root, bnode<
+                std::tuple<num_t<2>>,
+                std::tuple<bnode<std::tuple<num_t<1>>>, bnode<std::tuple<num_t<3>>>>
+            >>::value, "");
+            static_assert(std::is_same<b3::erase<num_t<1>>::root, bnode<std::tuple<num_t<2>, num_t<3>>>>::value, "");
+            static_assert(std::is_same<b3::find<num_t<3>>, bnode<std::tuple<num_t<3>>>>::value, "");
+            static_assert(std::is_same<b3::find<num_t<4>>, NIL>::value, "");
+            static_assert(height<b3>::value == 2 && height<b0>::value == 0, "");
+            
+            using input = std::tuple<
+                num_t<9>, num_t<2>, num_t<14>, num_t<7>, num_t<1>, num_t<12>, num_t<5>, num_t<15>,
+                num_t<3>, num_t<10>, num_t<8>, num_t<13>, num_t<4>, num_t<11>, num_t<6>, num_t<7>>;
+            using big = insert_tuple_t<btree<3, num_comp>, input>;
+            
+            static_assert(is_valid_btree<big>::value, "");
+            static_assert(std::is_same<walk_t<big>, merge_sort_t<input, num_comp>>::value, "");
+            static_assert(height<big>::value == 3, "");
+            static_assert(!std::is_same<search_t<big, num_t<13>>, NIL>::value, "");
+            static_assert(std::is_same<search_t<big, num_t<16>>, NIL>::value, "");
+            
+            using halved = remove_tuple_t<big, tuple_take_t<input, 8>>;
+            static_assert(is_valid_btree<halved>::value, "");
+            static_assert(std::is_same<walk_t<halved>, merge_sort_t<tuple_drop_t<input, 8>, num_comp>>::value, "");
+            static_assert(std::is_same<remove_tuple_t<halved, tuple_drop_t<input, 8>>, btree<3, num_comp>>::value, "");
+            static_assert(std::is_same<remove_t<big, num_t<16>>, big>::value, "");
+        }
+        
+        {
+            /// Set algebra: plain, AVL and B-tree operands, balanced results
+            using A = insert_tuple_t<NIL, std::tuple<num_t<5>, num_t<1>, num_t<9>, num_t<3>, num_t<7>>, num_comp>;
+            using B = avl::insert_tuple_t<NIL, std::tuple<num_t<4>, num_t<5>, num_t<6>, num_t<7>, num_t<8>>, num_comp>;
+            using C = insert_tuple_t<btree<2, num_comp>, std::tuple<num_t<2>, num_t<3>, num_t<4>>>;
+            
+            static_assert(array_eq(tuple_to_array_t<walk_t<set_union_t<A, B>>>::values,
+                {1UL,3UL,4UL,5UL,6UL,7UL,8UL,9UL}), "");
+            static_assert(array_eq(tuple_to_array_t<walk_t<set_intersection_t<A, B>>>::values, {5UL,7UL}), "");
+            static_assert(array_eq(tuple_to_array_t<walk_t<set_difference_t<A, B>>>::values, {1UL,3UL,9UL}), "");
+            static_assert(array_eq(tuple_to_array_t<walk_t<set_symmetric_difference_t<A, B>>>::values,
+                {1UL,3UL,4UL,6UL,8UL,9UL}), "");
+            static_assert(array_eq(tuple_to_array_t<walk_t<set_union_t<C, A>>>::values,
+                {1UL,2UL,3UL,4UL,5UL,7UL,9UL}), "");
+            
+            static_assert(avl::is_balanced<set_union_t<A, B>>::value, "");
+            static_assert(std::is_same<set_union_t<A, A>, build_balanced_t<walk_t<A>, num_comp>>::value, "");
+            static_assert(std::is_same<set_intersection_t<A, C>, leaf<num_t<3>, num_comp>>::value, "");
+            static_assert(std::is_same<set_difference_t<A, A>, NIL>::value, "");
+            static_assert(std::is_same<set_union_t<NIL, A, num_comp>, set_union_t<A, NIL>>::value, "");
+            
+            // B-tree operand is merged by its inorder walk
+            using D = insert_tuple_t<btree<3, num_comp>, std::tuple<
+                num_t<12>, num_t<2>, num_t<10>, num_t<6>, num_t<4>, num_t<8>, num_t<14>, num_t<16>, num_t<0>>>;
+            static_assert(array_eq(tuple_to_array_t<walk_t<set_union_t<A, D>>>::values,
+                {0UL,1UL,2UL,3UL,4UL,5UL,6UL,7UL,8UL,9UL,10UL,12UL,14UL,16UL}), "");
+            static_assert(array_eq(tuple_to_array_t<walk_t<set_symmetric_difference_t<D, B>>>::values,
+                {0UL,2UL,5UL,7UL,10UL,12UL,14UL,16UL}), "");
+            static_assert(std::is_same<set_intersection_t<A, D>, NIL>::value, "");
+            
+            // 200 and 150 keys: shared keys cross the batch boundary of both walks
+            using keys = interleaved<make_index_sequence_t<200>, make_index_sequence_t<150>>;
+            using E = build_balanced_t<keys::evens, num_comp>;
+            using O = avl::insert_tuple_t<NIL, keys::odds, num_comp>;
+            using all = paired<make_index_sequence_t<300>>::nums;
+            using tail = tuple_drop_t<keys::evens, 150>;
+            static_assert(std::is_same<walk_t<set_union_t<E, O>>, tuple_concat_t<tuple_take_t<all, 127>,
+                std::tuple<num_t<128>, num_t<130>>, tuple_drop_t<all, 132>, tail>>::value, "");
+            static_assert(std::is_same<walk_t<set_intersection_t<O, E>>,
+                std::tuple<num_t<126>, num_t<128>, num_t<130>>>::value, "");
+            static_assert(std::is_same<walk_t<set_difference_t<E, O>>,
+                tuple_concat_t<tuple_take_t<keys::evens, 63>, tuple_drop_t<keys::evens, 66>>>::value, "");
+            static_assert(std::is_same<walk_t<set_difference_t<O, E>>,
+                tuple_concat_t<tuple_take_t<keys::odds, 63>, tuple_drop_t<keys::odds, 66>>>::value, "");
+            static_assert(std::is_same<walk_t<set_symmetric_difference_t<E, O>>,
+                tuple_concat_t<tuple_take_t<all, 126>, tuple_drop_t<all, 132>, tail>>::value, "");
+        }
+        
+        {
+            /// Order statistics: dense indices, positional lookup and ranges in O(h)
+            using keys = std::tuple<num_t<2>, num_t<4>, num_t<6>, num_t<8>, num_t<10>, num_t<12>, num_t<14>>;
+            using T = insert_tuple_t<NIL, std::tuple<
+                num_t<8>, num_t<4>, num_t<12>, num_t<2>, num_t<6>, num_t<10>, num_t<14>>, num_comp>;
+            using U = avl::insert_tuple_t<NIL, keys, num_comp>;
+            
+            static_assert(size<T>::value == 7 && size<NIL>::value == 0, "");
+            static_assert(rank_t<T, num_t<2>>::value == 0 && rank_t<T, num_t<10>>::value == 4, "");
+            static_assert(rank_t<T, num_t<11>>::value == 5 && rank_t<T, num_t<99>>::value == 7, "");
+            static_assert(rank_t<NIL, num_t<1>, num_comp>::value == 0, "");
+            
+            static_assert(std::is_same<select_t<T, 0>::type, num_t<2>>::value, "");
+            static_assert(std::is_same<select_t<U, 4>::type, num_t<10>>::value, "");
+            static_assert(std::is_same<select_t<T, 7>, NIL>::value, "");
+            static_assert(rank_t<U, select_t<U, 6>::type>::value == 6, "");
+            
+            static_assert(std::is_same<lower_bound_t<T, num_t<6>>::type, num_t<6>>::value, "");
+            static_assert(std::is_same<lower_bound_t<T, num_t<7>>::type, num_t<8>>::value, "");
+            static_assert(std::is_same<upper_bound_t<U, num_t<6>>::type, num_t<8>>::value, "");
+            static_assert(std::is_same<upper_bound_t<U, num_t<1>>::type, num_t<2>>::value, "");
+            static_assert(std::is_same<lower_bound_t<T, num_t<15>>, NIL>::value, "");
+            static_assert(std::is_same<upper_bound_t<T, num_t<14>>, NIL>::value, "");
+            
+            static_assert(std::is_same<range_walk_t<T, num_t<4>, num_t<12>>, tuple_drop_t<tuple_take_t<keys, 5>, 1>>::value, "");
+            static_assert(std::is_same<range_walk_t<U, num_t<5>, num_t<9>>, std::tuple<num_t<6>, num_t<8>>>::value, "");
+            static_assert(std::is_same<range_walk_t<U, NIL, NIL>, keys>::value, "");
+            static_assert(std::is_same<range_walk_t<T, num_t<9>, num_t<10>>, std::tuple<>>::value, "");
+            
+            using V = insert_tuple_t<btree<2, num_comp>, keys>;
+            static_assert(std::is_same<range_walk_t<V, num_t<6>, NIL>, tuple_drop_t<keys, 2>>::value, "");
+            static_assert(std::is_same<range_walk_t<V, num_t<3>, num_t<13>>, range_walk_t<T, num_t<3>, num_t<13>>>::value, "");
+        }
+        
+        {
+            /// Map: number keys => arbitrary types
+            using m0 = map<num_comp>;
+            using m1 = insert_or_assign_t<m0, num_t<3>, float>;
+            using m2 = m1::insert_or_assign<num_t<1>, char>::insert_or_assign<num_t<2>, int>;
+            using m3 = insert_or_assign_t<m2, num_t<1>, double>;
+            
+            static_assert(std::is_same<at_t<m2, num_t<1>>, char>::value, "");
+            static_assert(std::is_same<at_t<m3, num_t<1>>, double>::value, "");
+            static_assert(std::is_same<m3::at<num_t<3>>, float>::value, "");
+            static_assert(std::is_same<find_t<m3, num_t<2>>, entry<num_t<2>, int>>::value, "");
+            static_assert(std::is_same<find_t<m3, num_t<4>>, NIL>::value, "");
+            static_assert(std::is_same<find_t<m0, num_t<4>>, NIL>::value, "");
+            static_assert(size<m3>::value == 3 && avl::is_balanced<m3::root>::value, "");
+            
+            using m4 = erase_t<m3, num_t<2>>;
+            static_assert(std::is_same<walk_t<m4>, std::tuple<entry<num_t<1>, double>, entry<num_t<3>, float>>>::value, "");
+            static_assert(std::is_same<erase_t<m4, num_t<7>>, m4>::value, "");
+            static_assert(std::is_same<m4::erase<num_t<1>>::erase<num_t<3>>, m0>::value, "");
+            
+            using built = build_map_t<std::tuple<
+                entry<num_t<5>, long>, entry<num_t<1>, char>, entry<num_t<3>, short>,
+                entry<num_t<2>, bool>, entry<num_t<4>, int>>, num_comp>;
+            static_assert(std::is_same<at_t<built, num_t<4>>, int>::value, "");
+            static_assert(height<built::root>::value == 3, "");
+            static_assert(std::is_same<at_t<insert_or_assign_t<built, num_t<5>, void>, num_t<5>>, void>::value, "");
+            
+            // build_map_t rejects repeated keys
+            using repeated = std::tuple<entry<num_t<1>, char>, entry<num_t<2>, int>, entry<num_t<2>, long>>;
+            static_assert(map_impl::distinct<walk_t<built>, num_comp>::value, "");
+            static_assert(!map_impl::distinct<repeated, num_comp>::value, "");
+        }
+        
+        {
+            /// Total order on arbitrary types
+            static_assert(type_comp::lt<int, float>::value != type_comp::lt<float, int>::value, "");
+            static_assert(type_comp::eq<int, int>::value && !type_comp::eq<int, unsigned>::value, "");
+            static_assert(type_hash<int>::value != type_hash<float>::value, "");
+            
+            // Types spelled the same by compiler can't be told apart: comparing them is a compile-time error.
+            // gcc spells lambdas and unnamed classes of one scope the same, clang adds their source location
+            auto first_lambda = []{};
+            auto second_lambda = []{};
+            struct {} first_unnamed;
+            struct {} second_unnamed;
+            (void)first_lambda; (void)second_lambda; (void)first_unnamed; (void)second_unnamed;
+            #if defined(__GNUC__) && !defined(__clang__)
+            static_assert(!type_order_impl::distinguishable<decltype(first_lambda), decltype(second_lambda)>::value, "");
+            static_assert(!type_order_impl::distinguishable<decltype(first_unnamed), decltype(second_unnamed)>::value, "");
+            #endif
+            static_assert(type_order_impl::distinguishable<decltype(first_lambda), decltype(first_lambda)>::value, "");
+            static_assert(type_order_impl::distinguishable<int, float>::value, "");
+            
+            /// Collisions tie-breaker compares spelled names
+            using type_order_impl::signature;
+            using type_order_impl::name_less;
+            static_assert(name_less(signature<num_t<1>>(), signature<num_t<2>>()), "");
+            static_assert(!name_less(signature<num_t<2>>(), signature<num_t<1>>()), "");
+            static_assert(name_less(signature<num_t<1>>(), signature<num_t<10>>()) !=
+                          name_less(signature<num_t<10>>(), signature<num_t<1>>()), "");
+            static_assert(!name_less(signature<char>(), signature<char>()), "");
+            
+            /// Same-sized types share one tree, order doesn't depend on insertion sequence
+            using types = std::tuple<int, float, unsigned, char, bool, long, double, void, NIL>;
+            using T = avl::insert_tuple_t<NIL, types, type_comp>;
+            using U = avl::insert_tuple_t<NIL, std::tuple<NIL, void, int, double, long, bool, char, unsigned, float>, type_comp>;
+            static_assert(size<T>::value == 9 && std::is_same<walk_t<T>, walk_t<U>>::value, "");
+            static_assert(std::is_same<search_t<T, float>::type, float>::value, "");
+            static_assert(std::is_same<search_t<avl::remove_t<T, float>, float>, NIL>::value, "");
+            static_assert(std::is_same<build_t<types, type_comp>::comp, type_comp>::value, "");
+            static_assert(std::is_same<walk_t<build_t<types, type_comp>>, walk_t<T>>::value, "");
+            
+            using M = map<type_comp>::insert_or_assign<int, num_t<4>>::insert_or_assign<float, num_t<5>>;
+            static_assert(at_t<M, float>::value == 5 && at_t<M, int>::value == 4, "");
+            static_assert(std::is_same<find_t<M, unsigned>, NIL>::value, "");
+        }
     }
     
     {